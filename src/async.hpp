@@ -0,0 +1,105 @@
+#pragma once
+
+#include <coroutine>
+#include <exception>
+#include <functional>
+#include <optional>
+#include <stop_token>
+#include <utility>
+#include "karger.hpp"
+
+
+/* A minimum cut computed by a coroutine which suspends itself periodically, so that it can share a
+thread with other tasks of an event-driven service. The coroutine only starts when awaited or
+resumed. Awaiting it from another coroutine resumes the latter with the best cut found once the
+coroutine is done. It can also be driven by hand with resume() until done(). */
+template <typename node_t>
+class MinCutTask
+{
+public:
+    struct promise_type
+    {
+        std::optional<GraphCut<node_t>> result;
+        std::exception_ptr exception;
+        std::coroutine_handle<> continuation; // the awaiting coroutine, if any
+
+        MinCutTask get_return_object() { return MinCutTask{std::coroutine_handle<promise_type>::from_promise(*this)}; }
+        std::suspend_always initial_suspend() noexcept { return {}; }
+        auto final_suspend() noexcept {
+            struct ResumeContinuation {
+                bool await_ready() noexcept { return false; }
+                std::coroutine_handle<> await_suspend(std::coroutine_handle<promise_type> handle) noexcept {
+                    auto const continuation = handle.promise().continuation;
+                    return continuation ? continuation : std::noop_coroutine();
+                }
+                void await_resume() noexcept {}
+            };
+            return ResumeContinuation{};
+        }
+        void return_value(std::optional<GraphCut<node_t>> cut) { result = std::move(cut); }
+        void unhandled_exception() { exception = std::current_exception(); }
+    };
+
+    MinCutTask(MinCutTask&& other) noexcept : handle{std::exchange(other.handle, {})} {}
+    MinCutTask& operator=(MinCutTask other) noexcept { std::swap(handle, other.handle); return *this; }
+    ~MinCutTask() { if (handle) handle.destroy(); }
+
+    bool done() const { return handle.done(); }
+    void resume() { handle.resume(); }
+
+    /* The best cut found, none if no trial was made. Only valid once done. */
+    std::optional<GraphCut<node_t>> result() {
+        if (handle.promise().exception) std::rethrow_exception(handle.promise().exception);
+        return std::move(handle.promise().result);
+    }
+
+    bool await_ready() const noexcept { return handle.done(); }
+    std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiting) noexcept {
+        handle.promise().continuation = awaiting;
+        return handle;
+    }
+    std::optional<GraphCut<node_t>> await_resume() { return result(); }
+
+private:
+    explicit MinCutTask(std::coroutine_handle<promise_type> handle) : handle{handle} {}
+    std::coroutine_handle<promise_type> handle;
+};
+
+
+/* Suspends the calling coroutine and hands it to the executor through schedule, which is to resume
+it later. Without an executor, the coroutine returns to whoever resumed it if driven by hand, but
+goes on if it is awaited: nobody would resume it otherwise, and the awaiting coroutine would hang. */
+struct YieldTo
+{
+    std::function<void(std::coroutine_handle<>)> const& schedule;
+
+    bool await_ready() const noexcept { return false; }
+    template <typename Promise>
+    bool await_suspend(std::coroutine_handle<Promise> handle) const {
+        if (schedule) { schedule(handle); return true; }
+        return !handle.promise().continuation;
+    }
+    void await_resume() const noexcept {}
+};
+
+
+/* Runs nb_repeat trials of the algorithm (any callable taking an EdgesVectorGraph<node_t>& and
+returning a GraphCut<node_t>) on the graph, which the coroutine owns. It suspends itself every
+trials_per_slice trials, the granularity at which the engines can be interrupted, and then stops
+early with the best cut found so far if a stop is requested. */
+template <typename node_t, typename Algorithm>
+MinCutTask<node_t> min_cut_async(EdgesVectorGraph<node_t> graph, Algorithm algorithm, std::size_t nb_repeat,
+    std::size_t trials_per_slice = 1, std::function<void(std::coroutine_handle<>)> schedule = {},
+    std::stop_token stop = {})
+{
+    std::optional<GraphCut<node_t>> best_minimum_cut;
+    for (std::size_t i = 0; i < nb_repeat; ++i) {
+        if (i && trials_per_slice && i % trials_per_slice == 0) {
+            co_await YieldTo{schedule};
+            if (stop.stop_requested()) break;
+        }
+        auto cut = algorithm(graph);
+        if (!best_minimum_cut || cut < *best_minimum_cut) best_minimum_cut = std::move(cut);
+    }
+    co_return best_minimum_cut;
+}
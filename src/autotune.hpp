@@ -0,0 +1,119 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <limits>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <stop_token>
+#include <thread>
+#include <vector>
+#include "karger.hpp"
+
+
+/* Parameters of the Karger-Stein algorithm chosen by autotune_karger_stein(), with the number of
+runs reaching the target success probability and the measured duration of a run. */
+struct TunedKargerStein
+{
+    KargerSteinParameters parameters;
+    std::size_t nb_runs;
+    double run_ms;
+};
+
+
+/* Number of independent runs finding a given minimum cut of a graph with n vertices with at least
+the target probability. */
+inline std::size_t karger_stein_runs(std::size_t n, KargerSteinParameters const& parameters, double target)
+{
+    auto const p = karger_stein_success_probability(n, parameters);
+    if (p >= 1) return 1;
+    return std::max<std::size_t>(1, std::ceil(std::log1p(-target) / std::log1p(-p)));
+}
+
+
+/* Parameters tried by default: 2, 3 or 4 children contracted by 1/√b (which keeps the depth of the
+recursion logarithmic), exact leaves of 4, 6 or 8 super-vertices, and a few variants of the original
+algorithm, some with a contraction shared by the children. None has more than about n² leaves (see
+KargerSteinParameters::leaves_exponent()). */
+inline std::vector<KargerSteinParameters> karger_stein_candidates()
+{
+    std::vector<KargerSteinParameters> candidates;
+    for (std::size_t b : {2, 3, 4})
+        for (std::size_t leaf_size : {4, 6, 8})
+            candidates.push_back({b, 1 / std::sqrt(double(b)), leaf_size, LeafSolver::exact});
+    candidates.push_back({2, 0.6, 6, LeafSolver::exact});
+    candidates.push_back({2, 1 / std::sqrt(2.0), 16, LeafSolver::contraction});
+    for (double shared_ratio : {0.9, 0.95}) {
+        candidates.push_back({2, 1 / std::sqrt(2.0), 6, LeafSolver::exact, shared_ratio});
+        candidates.push_back({3, 1 / std::sqrt(3.0), 6, LeafSolver::exact, shared_ratio});
+    }
+    return candidates;
+}
+
+
+/* Runs the Karger-Stein algorithm with the given parameters on the graph, and returns its duration,
+or nothing if it was given up after limit_ms: a watchdog thread then lowers the incumbent of the run
+to 0, which stops it. */
+template <typename node_t>
+std::optional<double> timed_karger_stein_run(EdgesVectorGraph<node_t> const& graph, KargerSteinParameters const& parameters,
+    double limit_ms)
+{
+    std::atomic<std::size_t> cut_off{std::numeric_limits<std::size_t>::max()};
+    std::optional<std::jthread> watchdog;
+    if (limit_ms < std::numeric_limits<double>::infinity())
+        watchdog.emplace([&](std::stop_token stop) {
+            std::mutex mutex;
+            std::condition_variable_any woken;
+            std::unique_lock lock{mutex};
+            woken.wait_for(lock, stop, std::chrono::duration<double, std::milli>{limit_ms}, [] { return false; });
+            if (!stop.stop_requested()) cut_off.store(0, std::memory_order_relaxed);
+        });
+    auto const start{std::chrono::steady_clock::now()};
+    karger_stein_union_find(graph, &cut_off, false, parameters);
+    auto const run_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    watchdog.reset(); // stopped and joined
+    if (cut_off.load(std::memory_order_relaxed) == 0) return std::nullopt;
+    return run_ms;
+}
+
+
+/* Picks the parameters of the Karger-Stein algorithm finding a given minimum cut of the graph with
+at least the target probability in the least time: each candidate runs nb_samples times on the
+graph, and its expected time is the number of runs it needs (karger_stein_runs()) times the mean
+duration of its samples. Candidates with more than about n² leaves, whose runs can take hours, are
+skipped. A candidate is given up as soon as its samples predict it slower than the best one so far,
+including while a sample runs (see timed_karger_stein_run()). The runs draw from the random engine
+of the calling thread. */
+template <typename node_t>
+TunedKargerStein autotune_karger_stein(EdgesVectorGraph<node_t> const& graph, double target, std::size_t nb_samples = 2,
+    std::vector<KargerSteinParameters> const& candidates = karger_stein_candidates())
+{
+    if (!(0 < target && target < 1)) throw std::invalid_argument("The target probability must be in (0, 1).");
+    std::optional<TunedKargerStein> best;
+    double best_ms = std::numeric_limits<double>::infinity();
+    for (auto const& candidate : candidates) {
+        if (candidate.leaves_exponent() > 2 + 1e-9) continue;
+        auto const nb_runs = karger_stein_runs(graph.n, candidate, target);
+        double elapsed_ms = 0;
+        std::size_t nb_done = 0;
+        bool given_up = false;
+        for (; nb_done < std::max<std::size_t>(1, nb_samples)
+                 && (nb_done == 0 || elapsed_ms / nb_done * nb_runs < best_ms); ++nb_done) {
+            auto const sample_ms = timed_karger_stein_run(graph, candidate, (nb_done + 1) * best_ms / nb_runs - elapsed_ms);
+            if ((given_up = !sample_ms)) break;
+            elapsed_ms += *sample_ms;
+        }
+        if (given_up) continue;
+        auto const run_ms = elapsed_ms / nb_done;
+        if (run_ms * nb_runs < best_ms) {
+            best_ms = run_ms * nb_runs;
+            best = {candidate, nb_runs, run_ms};
+        }
+    }
+    if (!best) throw std::invalid_argument("No parameters to tune.");
+    return *best;
+}
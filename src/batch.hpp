@@ -0,0 +1,112 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <filesystem>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+#include "karger.hpp"
+#include "instance_reader.hpp"
+
+
+/* An instance of a batch as loaded in the background, or the error raised while loading it. */
+template <typename node_t>
+struct LoadedInstance
+{
+    std::string file;
+    EdgesVectorGraph<node_t> graph;
+    double load_ms = 0;
+    std::exception_ptr error;
+};
+
+
+/* Lists the instance files of a batch, directories being replaced by the regular files they hold.
+The files are sorted by decreasing size, so that the largest instances start first and the smallest
+ones fill the end of the batch (longest processing time first). */
+inline std::vector<std::string> batch_instances(std::vector<char const*> const& paths)
+{
+    std::vector<std::pair<std::uintmax_t, std::string>> files;
+    for (std::filesystem::path path : paths) {
+        if (!std::filesystem::is_directory(path)) {
+            files.emplace_back(std::filesystem::file_size(path), path.string());
+            continue;
+        }
+        for (auto const& entry : std::filesystem::directory_iterator{path})
+            if (entry.is_regular_file()) files.emplace_back(entry.file_size(), entry.path().string());
+    }
+    std::ranges::sort(files, [](auto const& a, auto const& b) { return a.first != b.first ? a.first > b.first : a.second < b.second; });
+    std::vector<std::string> instances;
+    for (auto& [size, file] : files) instances.push_back(std::move(file));
+    return instances;
+}
+
+
+/* Calls solve(instance) on each instance of the batch, in order, from nb_solvers threads, while a
+loader thread reads the next instances in the background, at most prefetch of them ahead of the
+solvers. The solvers are meant to run their trials on a shared pool with parallel_for(): since the
+pool takes jobs in FIFO order, the threads left idle at the end of the trials of an instance start
+those of the next one. An instance which can't be read is given to solve with its error, and
+trusted skips the validation of binary instances. The first exception raised by solve stops the
+batch and is rethrown. */
+template <typename node_t, typename Solve>
+void run_batch(std::vector<std::string> const& files, Solve&& solve, bool trusted = false,
+    std::size_t nb_solvers = 2, std::size_t prefetch = 2)
+{
+    std::mutex mutex;
+    std::condition_variable changed;
+    std::deque<LoadedInstance<node_t>> loaded;
+    bool done_loading = false, stopping = false;
+    std::exception_ptr failure;
+
+    std::jthread loader{[&] {
+        for (auto const& file : files) {
+            {
+                std::unique_lock lock{mutex};
+                changed.wait(lock, [&] { return stopping || std::size(loaded) < prefetch; });
+                if (stopping) return;
+            }
+            LoadedInstance<node_t> instance{file, {}, 0, nullptr};
+            auto const start{std::chrono::steady_clock::now()};
+            try { instance.graph = read_instance<node_t>(file, trusted); }
+            catch (...) { instance.error = std::current_exception(); }
+            instance.load_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+            { std::scoped_lock lock{mutex}; loaded.push_back(std::move(instance)); }
+            changed.notify_all();
+        }
+        { std::scoped_lock lock{mutex}; done_loading = true; }
+        changed.notify_all();
+    }};
+
+    auto solver = [&] {
+        for (;;) {
+            LoadedInstance<node_t> instance;
+            {
+                std::unique_lock lock{mutex};
+                changed.wait(lock, [&] { return stopping || !loaded.empty() || done_loading; });
+                if (stopping || loaded.empty()) return;
+                instance = std::move(loaded.front());
+                loaded.pop_front();
+            }
+            changed.notify_all(); // room for the loader
+            try { solve(instance); }
+            catch (...) {
+                { std::scoped_lock lock{mutex}; if (!failure) failure = std::current_exception(); stopping = true; }
+                changed.notify_all();
+                return;
+            }
+        }
+    };
+    {
+        std::vector<std::jthread> solvers;
+        for (std::size_t i = 0; i < std::max<std::size_t>(1, nb_solvers); ++i) solvers.emplace_back(solver);
+    }
+    loader.join();
+    if (failure) std::rethrow_exception(failure);
+}
@@ -0,0 +1,234 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <coroutine>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <iostream>
+#include <limits>
+#include <numeric>
+#include <optional>
+#include <stop_token>
+#include <string>
+#include <vector>
+#include "karger.hpp"
+#include "dense_karger.hpp"
+#include "async.hpp"
+#include "parallel_karger.hpp"
+
+
+/* Exact minimum cut's size by the Stoer-Wagner algorithm on the matrix of edge multiplicities, in
+O(n³) [Stoer & Wagner, A Simple Min-Cut Algorithm, 1997]. Used as the ground truth of the checks. */
+template <typename node_t>
+std::size_t stoer_wagner(EdgesVectorGraph<node_t> const& graph)
+{
+    std::size_t const n = graph.n;
+    std::vector<std::size_t> weights(n * n);
+    for (auto e : graph.edges)
+        if (e.tail != e.head) { ++weights[e.tail * n + e.head]; ++weights[e.head * n + e.tail]; }
+
+    std::vector<std::size_t> active(n); // vertices not merged into another
+    std::iota(begin(active), end(active), std::size_t{0});
+    std::size_t best = std::numeric_limits<std::size_t>::max();
+    std::vector<std::size_t> keys;
+    std::vector<bool> added;
+    while (std::size(active) > 1) { // minimum cut phase: grows a maximum adjacency ordering
+        keys.assign(std::size(active), 0);
+        added.assign(std::size(active), false);
+        std::size_t previous = 0;
+        for (std::size_t i = 0; i < std::size(active); ++i) {
+            std::size_t next = std::size(active);
+            for (std::size_t j = 0; j < std::size(active); ++j)
+                if (!added[j] && (next == std::size(active) || keys[j] > keys[next])) next = j;
+            added[next] = true;
+            if (i + 1 == std::size(active)) { // the cut of the phase separates the last vertex
+                best = std::min(best, keys[next]);
+                auto const s = active[previous], t = active[next];
+                for (auto u : active) {
+                    weights[s * n + u] += weights[t * n + u];
+                    weights[u * n + s] = weights[s * n + u];
+                }
+                weights[s * n + s] = 0;
+                active[next] = active.back();
+                active.pop_back();
+                break;
+            }
+            previous = next;
+            for (std::size_t j = 0; j < std::size(active); ++j)
+                if (!added[j]) keys[j] += weights[active[next] * n + active[j]];
+        }
+    }
+    return best;
+}
+
+
+/* Tells whether the cut is a valid cut of the graph: two non-empty sides, a size equal to the
+number of edges crossing them, and these edges if the cut has kept them. */
+template <typename node_t>
+bool is_valid_cut(EdgesVectorGraph<node_t> const& graph, GraphCut<node_t> const& cut)
+{
+    if (std::size(cut.uf.subsets) != graph.n || cut.uf.nb_subsets != 2) return false;
+    if (crossing_edges_count(graph, cut) != cut.cut_size) return false;
+    if (cut.cut_edges.empty()) return true;
+    auto const sides = cut.get_sides();
+    return std::size(cut.cut_edges) == cut.cut_size
+        && std::ranges::all_of(cut.cut_edges, [&](auto e) { return sides[e.tail] != sides[e.head]; });
+}
+
+
+/* P(X <= k) for X following the binomial distribution B(n, p), summed in log space. */
+inline double binomial_cdf(std::size_t k, std::size_t n, double p)
+{
+    if (p <= 0) return 1;
+    if (p >= 1) return k >= n;
+    double cdf = 0;
+    for (std::size_t i = 0; i <= std::min(k, n); ++i)
+        cdf += std::exp(std::lgamma(n + 1.0) - std::lgamma(i + 1.0) - std::lgamma(n - i + 1.0)
+                        + i * std::log(p) + (n - i) * std::log1p(-p));
+    return std::min(cdf, 1.0);
+}
+
+
+/* Checks every engine on a graph whose minimum cut's size is computed by stoer_wagner(), and compared
+to the known one if any. Each trial must return a valid cut no smaller than the minimum cut. The
+number of trials finding a minimum cut is then tested against the lower bound of the success
+probability given by the theory (1 / C(n, 2) for Karger's algorithm, 1 / (2 log₂(n) + 1) for
+Karger-Stein's, karger_stein_success_probability() for other shapes of its recursion): the check
+fails if so few successes have a probability below 10⁻⁶ under this bound. The number of trials aims
+at 30 expected successes, within a budget of trials × size of the graph (edges, or n² for the dense
+engines, 10⁷ by default), and the statistical test is skipped for graphs too large for the budget. Trials are seeded
+from the seed and their index. Prints a line per check and returns the number of failed checks. */
+template <typename node_t>
+std::size_t check_engines(std::string const& name, EdgesVectorGraph<node_t> const& graph,
+    std::optional<std::size_t> known_min_cut, std::uint64_t seed, double budget = 1e7, std::ostream& out = std::cout)
+{
+    constexpr double SIGNIFICANCE = 1e-6;
+    constexpr std::size_t MIN_TRIALS = 20;
+
+    std::size_t nb_failures = 0;
+    auto report = [&](bool success, std::string const& what) {
+        out << (success ? "PASS " : "FAIL ") << name << ": " << what << '\n';
+        nb_failures += !success;
+    };
+
+    auto const min_cut = stoer_wagner(graph);
+    if (known_min_cut)
+        report(min_cut == *known_min_cut, "Stoer-Wagner finds " + std::to_string(min_cut) +
+            ", expected " + std::to_string(*known_min_cut));
+
+    DenseGraph<node_t> const dense_graph{graph};
+    double const n = graph.n;
+    double const karger_probability = 2 / (n * (n - 1));
+    double const karger_stein_probability = 1 / (2 * std::log2(n) + 1);
+    double const m = std::max<std::size_t>(1, std::size(graph.edges));
+    KargerSteinParameters const wide{4, 0.5, 4, LeafSolver::exact, 0.9};
+    KargerSteinParameters const contracted_leaves{2, 1 / std::sqrt(2.0), 12, LeafSolver::contraction};
+    KargerSteinParameters const recomputed{3, 1 / std::sqrt(3.0), 6, LeafSolver::exact, 0.9, 2};
+    ThreadPool pool{2}; // with a tiny grain, for the parallel engines to take all their paths
+    struct Engine { std::string name; double probability, size; std::function<GraphCut<node_t>(EdgesVectorGraph<node_t>&)> run; };
+    Engine const engines[] = {
+        {"karger_union_find", karger_probability, m, [](auto& graph) { return karger_union_find(graph, true); }},
+        {"karger_union_find (shared graph)", karger_probability, m, [&](auto&) { return karger_union_find(graph, true); }},
+        {"parallel_karger_union_find", karger_probability, m, [&](auto&) { return parallel_karger_union_find(graph, pool, true, 4); }},
+        {"parallel_karger_mst", karger_probability, m, [&](auto&) { return parallel_karger_mst(graph, pool, true, 4); }},
+        {"karger_stein_union_find", karger_stein_probability, m, [](auto& graph) { return karger_stein_union_find(graph, nullptr, true); }},
+        {"karger_stein_union_find (4 children, shared contraction)", karger_stein_success_probability(graph.n, wide), m,
+            [&](auto& graph) { return karger_stein_union_find(graph, nullptr, true, wide); }},
+        {"karger_stein_union_find (contracted leaves)", karger_stein_success_probability(graph.n, contracted_leaves), m,
+            [&](auto& graph) { return karger_stein_union_find(graph, nullptr, true, contracted_leaves); }},
+        {"karger_stein_union_find (recomputed graphs)", karger_stein_success_probability(graph.n, recomputed), m,
+            [&](auto& graph) { return karger_stein_union_find(graph, nullptr, true, recomputed); }},
+        {"karger_dense", karger_probability, n * n, [&](auto&) { return karger_dense(dense_graph); }},
+        {"karger_stein_dense", karger_stein_probability, n * n, [&](auto&) { return karger_stein_dense(dense_graph); }},
+    };
+
+    auto copy = graph;
+    for (std::size_t e = 0; e < std::size(engines); ++e) {
+        auto const& engine = engines[e];
+        auto const wanted = static_cast<std::size_t>(std::ceil(30 / engine.probability));
+        auto const affordable = static_cast<std::size_t>(budget / engine.size);
+        bool const testable = wanted <= affordable;
+        auto const nb_trials = testable ? std::max(wanted, MIN_TRIALS) : MIN_TRIALS;
+
+        std::size_t nb_successes = 0, nb_invalid = 0, best = std::numeric_limits<std::size_t>::max();
+        for (std::size_t trial = 0; trial < nb_trials; ++trial) {
+            seed_trial(seed, e << 32 | trial);
+            auto const cut = engine.run(copy);
+            if (!is_valid_cut(graph, cut) || cut.cut_size < min_cut) ++nb_invalid;
+            nb_successes += cut.cut_size == min_cut;
+            best = std::min(best, cut.cut_size);
+        }
+        report(nb_invalid == 0, engine.name + " returns valid cuts (" + std::to_string(nb_invalid) + " invalid out of "
+            + std::to_string(nb_trials) + ", best " + std::to_string(best) + ")");
+        if (testable) {
+            auto const p_value = binomial_cdf(nb_successes, nb_trials, engine.probability);
+            report(p_value >= SIGNIFICANCE, engine.name + " success rate " + std::to_string(nb_successes) + "/"
+                + std::to_string(nb_trials) + " against a bound of " + std::to_string(engine.probability)
+                + " (p-value " + std::to_string(p_value) + ")");
+        }
+    }
+    return nb_failures;
+}
+
+
+/* Awaits a task from another coroutine, returning its result. */
+template <typename node_t>
+MinCutTask<node_t> await_task(MinCutTask<node_t> task)
+{
+    co_return co_await task;
+}
+
+
+/* Checks the suspension points of min_cut_async(): 10 trials in slices of 3 suspend 3 times when
+driven by hand or by an executor, don't suspend when awaited without an executor, and stop after
+the first slice on a stop request. Prints a line per check and returns the number of failed
+checks. */
+inline std::size_t check_async(std::ostream& out = std::cout)
+{
+    std::size_t nb_failures = 0;
+    auto report = [&](bool success, std::string const& what) {
+        out << (success ? "PASS " : "FAIL ") << "async: " << what << '\n';
+        nb_failures += !success;
+    };
+    using node_t = std::uint32_t;
+    EdgesVectorGraph<node_t> const graph{4, {{0, 1}, {1, 2}, {2, 3}, {3, 0}}};
+    std::size_t nb_trials = 0;
+    auto const algorithm = [&](auto& graph) { ++nb_trials; return karger_union_find(graph); };
+    auto const valid = [&](std::optional<GraphCut<node_t>> const& cut) { return cut && is_valid_cut(graph, *cut); };
+
+    auto task = min_cut_async(graph, algorithm, 10, 3);
+    std::size_t nb_resumes = 0;
+    for (; !task.done(); ++nb_resumes) task.resume();
+    report(nb_resumes == 4 && nb_trials == 10 && valid(task.result()), "driven by hand, " + std::to_string(nb_resumes)
+        + " resumes for " + std::to_string(nb_trials) + " trials");
+
+    nb_trials = 0;
+    auto awaiting = await_task(min_cut_async(graph, algorithm, 10, 3));
+    awaiting.resume();
+    report(awaiting.done() && nb_trials == 10 && valid(awaiting.result()), "awaited without an executor, done after "
+        + std::to_string(nb_trials) + " trials");
+
+    nb_trials = 0;
+    std::deque<std::coroutine_handle<>> queue;
+    std::function<void(std::coroutine_handle<>)> schedule = [&](std::coroutine_handle<> handle) { queue.push_back(handle); };
+    std::size_t nb_scheduled = 0;
+    awaiting = await_task(min_cut_async(graph, algorithm, 10, 3, schedule));
+    for (awaiting.resume(); !queue.empty(); ++nb_scheduled) {
+        auto const handle = queue.front();
+        queue.pop_front();
+        handle.resume();
+    }
+    report(awaiting.done() && nb_scheduled == 3 && nb_trials == 10 && valid(awaiting.result()), "awaited with an executor, "
+        + std::to_string(nb_scheduled) + " slices scheduled for " + std::to_string(nb_trials) + " trials");
+
+    nb_trials = 0;
+    std::stop_source stop;
+    task = min_cut_async(graph, algorithm, 10, 3, {}, stop.get_token());
+    task.resume();
+    stop.request_stop();
+    task.resume();
+    report(task.done() && nb_trials == 3 && valid(task.result()), "stopped after " + std::to_string(nb_trials) + " trials");
+    return nb_failures;
+}
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+
+/* State of a campaign of trials, saved periodically so that a preempted run resumes where it left
+off. Since each trial reseeds the engine from the seed of the campaign and its own index (see
+seed_trial()), the state of the random stream is entirely given by the seed and the number of trials
+done. The best cut is stored as the side of each vertex, the results of the algorithms already done
+as their best cut size and duration. */
+struct Checkpoint
+{
+    struct Result { std::optional<std::size_t> cut_size; std::uint64_t duration_ms; };
+
+    std::string instance;
+    std::size_t n; // number of vertices of the instance
+    std::uint64_t seed;
+    std::vector<Result> results; // algorithms done, in order
+    std::size_t nb_trials_done; // of the current algorithm, whose trials [0, nb_trials_done) are done
+    std::uint64_t elapsed_ms; // running time of the current algorithm
+    std::optional<std::size_t> cut_size; // of the best cut of the current algorithm
+    std::vector<std::uint8_t> sides;
+
+    /* Writes the checkpoint to a temporary file renamed over the given one, so that a crash while
+    saving leaves the previous checkpoint intact. */
+    void save(std::filesystem::path const& file) const {
+        auto temporary = file;
+        temporary += ".tmp";
+        {
+            std::ofstream output{temporary};
+            output << "karger-checkpoint 1\n" << instance << '\n' << n << ' ' << seed << '\n' << std::size(results) << '\n';
+            for (auto const& result : results) output << (result.cut_size ? std::to_string(*result.cut_size) : "-") << ' ' << result.duration_ms << '\n';
+            output << nb_trials_done << ' ' << elapsed_ms << ' ' << (cut_size ? std::to_string(*cut_size) : "-") << '\n';
+            for (auto side : sides) output << static_cast<char>('0' + side);
+            output << '\n';
+            if (!output.flush()) throw std::runtime_error("Cannot write the checkpoint.");
+        }
+        std::filesystem::rename(temporary, file);
+    }
+
+    static Checkpoint load(std::filesystem::path const& file) {
+        std::ifstream input{file};
+        if (!input) throw std::runtime_error("Such checkpoint doesn't exist.");
+        auto read_size = [&input]() -> std::optional<std::size_t> {
+            std::string word;
+            input >> word;
+            if (word == "-") return std::nullopt;
+            return std::stoull(word);
+        };
+        Checkpoint checkpoint;
+        std::string magic, sides;
+        int version;
+        std::size_t nb_results;
+        input >> magic >> version >> std::ws;
+        if (magic != "karger-checkpoint" || version != 1) throw std::runtime_error("Not a checkpoint file.");
+        std::getline(input, checkpoint.instance);
+        input >> checkpoint.n >> checkpoint.seed >> nb_results;
+        for (std::size_t i = 0; i < nb_results; ++i) {
+            auto const cut_size = read_size();
+            std::uint64_t duration_ms;
+            input >> duration_ms;
+            checkpoint.results.push_back({cut_size, duration_ms});
+        }
+        input >> checkpoint.nb_trials_done >> checkpoint.elapsed_ms;
+        checkpoint.cut_size = read_size();
+        if (checkpoint.cut_size) input >> sides;
+        if (!input) throw std::runtime_error("Corrupted checkpoint file.");
+        for (auto side : sides) checkpoint.sides.push_back(side == '1');
+        if (checkpoint.cut_size && std::size(checkpoint.sides) != checkpoint.n)
+            throw std::runtime_error("Corrupted checkpoint file.");
+        return checkpoint;
+    }
+};
@@ -0,0 +1,230 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cmath>
+#include <cstdint>
+#include <optional>
+#include <random>
+#include <stack>
+#include <vector>
+#include "karger.hpp"
+
+
+/* Represents a multigraph with n vertices as a matrix of edge multiplicities along with an adjacency
+bitset per vertex. Contracting a vertex into another ORs their adjacency rows word by word, and the
+number of edges between two super-vertices is read directly from the matrix. Vertices are kept
+packed between 0 and n - 1 (a removed vertex is replaced by the last one) while the Union-Find
+structure tracks the original vertices merged into each of them. It uses O(n²) memory and is meant
+for dense graphs with up to a few thousand vertices. */
+template <typename node_t>
+struct DenseGraph
+{
+    using weight_t = std::uint32_t;
+    using word_t = std::uint64_t;
+    static constexpr std::size_t WORD_BITS = 64;
+
+    node_t n; // number of super-vertices
+    std::size_t stride; // row length of the matrix, i.e. the number of vertices at construction
+    std::size_t nb_words; // row length of the adjacency bitsets
+    std::vector<weight_t> weights;
+    std::vector<word_t> adjacency;
+    std::vector<std::size_t> degrees;
+    std::size_t total_degree = 0; // twice the number of edges between super-vertices
+    std::vector<node_t> representatives; // an original vertex of each super-vertex
+    UnionFind<node_t> uf; // partition of the original vertices
+
+    DenseGraph(node_t n, UnionFind<node_t> uf) : n{n}, stride{n}, nb_words{(n + WORD_BITS - 1) / WORD_BITS},
+        weights(stride * stride), adjacency(stride * nb_words), degrees(n), representatives(n), uf{std::move(uf)} {}
+
+    DenseGraph(EdgesVectorGraph<node_t> const& graph) : DenseGraph{graph.n, {graph.n}} {
+        for (node_t u = 0; u < n; ++u) representatives[u] = u;
+        for (auto [u, v] : graph.edges) {
+            if (u == v) continue;
+            if (weight(u, v)++ == 0) { set(u, v); set(v, u); }
+            ++weight(v, u); ++degrees[u]; ++degrees[v];
+        }
+        total_degree = 2 * std::count_if(begin(graph.edges), end(graph.edges), [](auto e) { return e.tail != e.head; });
+    }
+
+    weight_t& weight(node_t u, node_t v) { return weights[u * stride + v]; }
+    weight_t weight(node_t u, node_t v) const { return weights[u * stride + v]; }
+    word_t* row(node_t u) { return adjacency.data() + u * nb_words; }
+    word_t const* row(node_t u) const { return adjacency.data() + u * nb_words; }
+    void set(node_t u, node_t v) { row(u)[v / WORD_BITS] |= word_t{1} << (v % WORD_BITS); }
+    void reset(node_t u, node_t v) { row(u)[v / WORD_BITS] &= ~(word_t{1} << (v % WORD_BITS)); }
+
+    /* Calls f on each neighbor of u until it returns true. */
+    template <typename F>
+    void for_each_neighbor(node_t u, F&& f) const {
+        auto const* r = row(u);
+        for (std::size_t w = 0, nb_used_words = (n + WORD_BITS - 1) / WORD_BITS; w < nb_used_words; ++w)
+            for (auto bits = r[w]; bits; bits &= bits - 1)
+                if (f(static_cast<node_t>(w * WORD_BITS + std::countr_zero(bits)))) return;
+    }
+
+    /* Merges v into u, removing the edges between them, then moves the last vertex into v's place. */
+    void merge(node_t u, node_t v) {
+        auto const removed_edges = weight(u, v);
+        for_each_neighbor(v, [&](node_t x) {
+            if (x != u) {
+                weight(x, u) = weight(u, x) += weight(v, x);
+                set(x, u); reset(x, v);
+            }
+            weight(x, v) = weight(v, x) = 0;
+            return false;
+        });
+        auto* const ru = row(u); auto const* const rv = row(v);
+        for (std::size_t w = 0; w < nb_words; ++w) ru[w] |= rv[w];
+        reset(u, u); reset(u, v);
+        degrees[u] = degrees[u] + degrees[v] - 2 * removed_edges;
+        total_degree -= 2 * removed_edges;
+        uf.merge(representatives[u], representatives[v]);
+
+        auto const last = static_cast<node_t>(n - 1);
+        if (v != last) { // v's row and column are now empty
+            for_each_neighbor(last, [&](node_t x) {
+                weight(x, v) = weight(v, x) = weight(last, x);
+                weight(x, last) = weight(last, x) = 0;
+                set(x, v); reset(x, last);
+                return false;
+            });
+            std::copy_n(row(last), nb_words, row(v));
+            degrees[v] = degrees[last];
+            representatives[v] = representatives[last];
+        }
+        std::fill_n(row(last), nb_words, 0);
+        degrees[last] = 0;
+        --n;
+    }
+
+    /* Contracts an edge chosen uniformly at random: its first extremity is chosen with a probability
+    proportional to its degree, the second one proportionally to the multiplicity of the edge. */
+    template <typename URBG>
+    void contract_random_edge(URBG& mt) {
+        auto r = std::uniform_int_distribution<std::size_t>{0, total_degree - 1}(mt);
+        node_t u = 0;
+        while (r >= degrees[u]) r -= degrees[u++];
+        node_t v = u;
+        for_each_neighbor(u, [&](node_t x) {
+            if (r < weight(u, x)) { v = x; return true; }
+            r -= weight(u, x);
+            return false;
+        });
+        merge(u, v);
+    }
+
+    /* Returns a copy whose matrix is shrunk to the current number of super-vertices. */
+    DenseGraph compacted() const {
+        DenseGraph graph{n, uf};
+        graph.representatives.assign(begin(representatives), begin(representatives) + n);
+        graph.degrees.assign(begin(degrees), begin(degrees) + n);
+        graph.total_degree = total_degree;
+        for (node_t u = 0; u < n; ++u)
+            for_each_neighbor(u, [&](node_t v) {
+                graph.weight(u, v) = weight(u, v);
+                graph.set(u, v);
+                return false;
+            });
+        return graph;
+    }
+};
+
+
+/* Returns true when the graph is dense enough for the DenseGraph engine to beat the edge-list one
+in the Karger-Stein algorithm, where each intermediate edge-list graph copies its edges and its
+Union-Find structure. On the DIMACS instances, the dense engine already wins with an average degree
+of n / 16. A single Karger contraction, however, stays faster on the edge list since it doesn't
+have to copy the O(n²) matrix. */
+template <typename node_t>
+bool is_dense(EdgesVectorGraph<node_t> const& graph)
+{
+    constexpr std::size_t DENSE_MAX_VERTICES = 4096;
+    std::size_t const n = graph.n;
+    return n <= DENSE_MAX_VERTICES && 32 * std::size(graph.edges) >= n * n;
+}
+
+
+/* Karger's contraction algorithm on a DenseGraph in O(n²). The given graph is left untouched, a
+copy is contracted until it has two super-vertices. The graph is assumed to be connected. */
+template <typename node_t>
+GraphCut<node_t> karger_dense(DenseGraph<node_t> const& input_graph)
+{
+    auto& mt = prng_engine();
+    auto graph = input_graph;
+    while (graph.n > 2) graph.contract_random_edge(mt);
+    return {graph.weight(0, 1), std::move(graph.uf)};
+}
+
+
+/* Karger-Stein's recursive algorithm on a DenseGraph in O(n² log(n)). Intermediate graphs are
+compacted so that each level of the recursion works on smaller matrices. As in
+karger_stein_union_find(), leaves no better than the shared incumbent aren't turned into cuts and
+the run stops once the best cut reaches the lower bound given by the connectivity of the graph.
+Since the degrees of the super-vertices are maintained, the minimum degree cut of each intermediate
+graph is checked as an upper bound in O(n). */
+template <typename node_t>
+GraphCut<node_t> karger_stein_dense(DenseGraph<node_t> const& input_graph,
+    std::atomic<std::size_t> const* incumbent = nullptr)
+{
+    auto contract = [&mt = prng_engine()](DenseGraph<node_t> graph, node_t nb_vertices) {
+        while (graph.n > nb_vertices) graph.contract_random_edge(mt);
+        return graph.compacted();
+    };
+
+    /* Exact cut of a leaf graph, which is already compacted, built only if below the bound. */
+    auto exact_cut = [](DenseGraph<node_t>&& graph, std::size_t bound) {
+        return with_small_size(graph.n, [&]<std::size_t K>() -> std::optional<GraphCut<node_t>> {
+            std::array<std::array<std::size_t, K>, K> weights;
+            for (std::size_t u = 0; u < K; ++u)
+                for (std::size_t v = 0; v < K; ++v) weights[u][v] = graph.weight(u, v);
+            auto const [size, side] = exact_small_cut(weights);
+            if (size >= bound) return std::nullopt;
+            return make_small_cut<K>(size, side, graph.representatives, std::move(graph.uf));
+        });
+    };
+
+    GraphCut<node_t> best_minimum_cut{std::numeric_limits<std::size_t>::max(), {{}}};
+    auto bound = [&] {
+        return std::min(best_minimum_cut.cut_size,
+            incumbent ? incumbent->load(std::memory_order_relaxed) : std::numeric_limits<std::size_t>::max());
+    };
+
+    /* Keeps the cut separating a super-vertex of minimum degree from the others if it improves
+    the bound. */
+    auto minimum_degree_cut = [&](DenseGraph<node_t> const& graph) {
+        node_t const r = std::min_element(begin(graph.degrees), begin(graph.degrees) + graph.n) - begin(graph.degrees);
+        if (graph.degrees[r] >= bound()) return;
+        auto uf = graph.uf;
+        for (node_t u = 0; u < graph.n; ++u)
+            if (u != r) uf.merge(graph.representatives[u], graph.representatives[r == 0]);
+        best_minimum_cut = {graph.degrees[r], std::move(uf)};
+    };
+
+    UnionFind<node_t> components{input_graph.n};
+    for (node_t u = 0; u < input_graph.n; ++u)
+        input_graph.for_each_neighbor(u, [&](node_t v) { components.merge(u, v); return false; });
+    std::size_t const lower_bound = components.nb_subsets <= 1;
+
+    constexpr double INV_SQRT_2 = 1.0 / std::sqrt(2);
+    std::stack<DenseGraph<node_t>, std::vector<DenseGraph<node_t>>> graphs;
+    graphs.push(input_graph.compacted());
+
+    while (!graphs.empty() && bound() > lower_bound)
+    {
+        auto graph = std::move(graphs.top());
+        graphs.pop();
+
+        if (graph.n <= 6) {
+            if (auto cut = exact_cut(std::move(graph), bound())) best_minimum_cut = std::move(*cut);
+        } else {
+            minimum_degree_cut(graph);
+            node_t t = 1 + std::ceil(graph.n * INV_SQRT_2);
+            graphs.push(contract(graph, t));
+            graphs.push(contract(std::move(graph), t));
+        }
+    }
+
+    return best_minimum_cut;
+}
@@ -0,0 +1,203 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <numeric>
+#include <optional>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "karger.hpp"
+
+
+/* A generated graph with its minimum cut's size, when known by construction. */
+template <typename node_t>
+struct GeneratedGraph
+{
+    EdgesVectorGraph<node_t> graph;
+    std::optional<std::size_t> min_cut;
+};
+
+
+/* Adds to the edges a random Hamiltonian cycle over the given vertices, which are shuffled. Every
+cut splitting the vertices crosses at least two edges of the cycle. */
+template <typename node_t, typename URBG>
+void add_random_cycle(std::vector<Edge<node_t>>& edges, std::vector<node_t>& vertices, URBG& mt)
+{
+    if (std::size(vertices) < 2) return;
+    std::ranges::shuffle(vertices, mt);
+    for (std::size_t i = 0; i < std::size(vertices); ++i)
+        edges.push_back({vertices[i], vertices[(i + 1) % std::size(vertices)]});
+}
+
+
+/* Keeps the largest connected component of the graph, whose vertices are renumbered in order, since
+the algorithms expect a connected graph. */
+template <typename node_t>
+EdgesVectorGraph<node_t> largest_component(EdgesVectorGraph<node_t> const& graph)
+{
+    UnionFind uf{graph.n};
+    for (auto e : graph.edges) uf.merge(e.tail, e.head);
+    if (uf.nb_subsets <= 1) return graph;
+    node_t largest = 0;
+    for (node_t u = 0; u < graph.n; ++u)
+        if (uf.subsets[uf.find(u)].size > uf.subsets[uf.find(largest)].size) largest = u;
+    largest = uf.find(largest);
+    std::vector<node_t> index(graph.n);
+    EdgesVectorGraph<node_t> component{0, {}};
+    for (node_t u = 0; u < graph.n; ++u)
+        if (uf.find(u) == largest) index[u] = component.n++;
+    for (auto e : graph.edges)
+        if (uf.find(e.tail) == largest) component.edges.push_back({index[e.tail], index[e.head]});
+    return component;
+}
+
+
+/* Erdős–Rényi graph G(n, p): each of the n(n - 1)/2 pairs of vertices is an edge with probability
+p. The pairs are walked row by row with geometric gaps between the kept ones, in O(n + pn²) random
+draws. Only its largest connected component is kept, whose minimum cut isn't known (it is the
+minimum degree with high probability when p is well above ln(n)/n). */
+template <typename node_t, typename URBG>
+GeneratedGraph<node_t> erdos_renyi(node_t n, double p, URBG& mt)
+{
+    GeneratedGraph<node_t> generated{{n, {}}, std::nullopt};
+    if (n < 2 || p <= 0) return generated;
+    p = std::min(p, 1.0);
+    generated.graph.edges.reserve(static_cast<std::size_t>(1.05 * p * n * (n - 1.0) / 2));
+    std::geometric_distribution<std::uint64_t> gap{p};
+    for (std::uint64_t u = 0, v = 1 + gap(mt);; v += 1 + gap(mt)) {
+        for (; u + 1 < n && v >= n; ++u) v = v - n + u + 2; // carry over to the next rows
+        if (u + 1 >= n) break;
+        generated.graph.edges.push_back({static_cast<node_t>(u), static_cast<node_t>(v)});
+    }
+    generated.graph = largest_component(generated.graph);
+    return generated;
+}
+
+
+/* Two clusters of n/2 and n - n/2 random vertices, each the union of r random Hamiltonian cycles,
+joined by k random edges. Any cut splitting a cluster crosses at least 2r edges, so if 2r > k the
+minimum cut is the planted one, of size k. */
+template <typename node_t, typename URBG>
+GeneratedGraph<node_t> planted_cut(node_t n, std::size_t r, std::size_t k, URBG& mt)
+{
+    if (n < 2) throw std::runtime_error("A planted cut needs at least two vertices.");
+    if (2 * r <= k) throw std::runtime_error("The planted cut must be smaller than twice the number of cycles.");
+    std::vector<node_t> vertices(n);
+    std::iota(begin(vertices), end(vertices), node_t{0});
+    std::ranges::shuffle(vertices, mt);
+    std::vector<node_t> first(begin(vertices), begin(vertices) + n / 2), second(begin(vertices) + n / 2, end(vertices));
+
+    GeneratedGraph<node_t> generated{{n, {}}, k};
+    generated.graph.edges.reserve(r * n + k);
+    for (std::size_t i = 0; i < r; ++i) {
+        add_random_cycle(generated.graph.edges, first, mt);
+        add_random_cycle(generated.graph.edges, second, mt);
+    }
+    std::uniform_int_distribution<std::size_t> pick_first{0, std::size(first) - 1}, pick_second{0, std::size(second) - 1};
+    for (std::size_t i = 0; i < k; ++i)
+        generated.graph.edges.push_back({first[pick_first(mt)], second[pick_second(mt)]});
+    return generated;
+}
+
+
+/* Random d-regular multigraph on n vertices (d even) as the union of d/2 random Hamiltonian cycles.
+Every cut crosses at least d edges and a single vertex is such a cut, so the minimum cut is d. */
+template <typename node_t, typename URBG>
+GeneratedGraph<node_t> random_regular(node_t n, std::size_t d, URBG& mt)
+{
+    if (n < 2) throw std::runtime_error("A regular graph needs at least two vertices.");
+    if (d % 2) throw std::runtime_error("The degree of a regular graph must be even.");
+    std::vector<node_t> vertices(n);
+    std::iota(begin(vertices), end(vertices), node_t{0});
+    GeneratedGraph<node_t> generated{{n, {}}, d};
+    generated.graph.edges.reserve(d / 2 * n);
+    for (std::size_t i = 0; i < d / 2; ++i) add_random_cycle(generated.graph.edges, vertices, mt);
+    return generated;
+}
+
+
+/* R-MAT graph with 2^scale vertices and m edges [Chakrabarti et al., R-MAT: A Recursive Model for
+Graph Mining, 2004]: each edge picks its cell of the adjacency matrix by descending into one of the
+four quadrants with probabilities a, b, c and 1 - a - b - c, scale times. Self-loops are redrawn.
+The skewed degrees leave many isolated vertices, so only the largest connected component is kept,
+whose minimum cut isn't known. */
+template <typename node_t, typename URBG>
+GeneratedGraph<node_t> rmat(unsigned scale, std::size_t m, URBG& mt, double a = 0.57, double b = 0.19, double c = 0.19)
+{
+    if (scale == 0 || scale >= std::numeric_limits<node_t>::digits) throw std::runtime_error("Invalid R-MAT scale.");
+    GeneratedGraph<node_t> generated{{static_cast<node_t>(node_t{1} << scale), {}}, std::nullopt};
+    generated.graph.edges.reserve(m);
+    std::uniform_real_distribution<double> uniform;
+    while (std::size(generated.graph.edges) < m) {
+        node_t u = 0, v = 0;
+        for (unsigned level = 0; level < scale; ++level) {
+            auto const x = uniform(mt);
+            u = 2 * u + (x >= a + b);
+            v = 2 * v + (x >= a && (x < a + b || x >= a + b + c));
+        }
+        if (u != v) generated.graph.edges.push_back({u, v});
+    }
+    generated.graph = largest_component(generated.graph);
+    return generated;
+}
+
+
+/* rows × cols grid, each vertex linked to its 4 neighbors. A corner has degree 2 and every cut
+crosses at least 2 edges, so the minimum cut is 2 (1 for a path, none for a single vertex). */
+template <typename node_t>
+GeneratedGraph<node_t> grid(node_t rows, node_t cols)
+{
+    if (rows == 0 || cols == 0) throw std::runtime_error("A grid needs at least one row and one column.");
+    GeneratedGraph<node_t> generated{{static_cast<node_t>(rows * cols), {}}, std::nullopt};
+    if (rows * cols > 1) generated.min_cut = rows == 1 || cols == 1 ? 1 : 2;
+    generated.graph.edges.reserve(2 * std::size_t{rows} * cols);
+    for (node_t i = 0; i < rows; ++i)
+        for (node_t j = 0; j < cols; ++j) {
+            node_t const u = i * cols + j;
+            if (j + 1 < cols) generated.graph.edges.push_back({u, static_cast<node_t>(u + 1)});
+            if (i + 1 < rows) generated.graph.edges.push_back({u, static_cast<node_t>(u + cols)});
+        }
+    return generated;
+}
+
+
+/* Generates a graph from a specification "kind:parameters", with comma-separated parameters:
+   - "er:n,p" for erdos_renyi(),
+   - "planted:n,r,k" for planted_cut(),
+   - "regular:n,d" for random_regular(),
+   - "rmat:scale,m" or "rmat:scale,m,a,b,c" for rmat(),
+   - "grid:rows,cols" for grid(). */
+template <typename node_t, typename URBG>
+GeneratedGraph<node_t> generate(std::string_view spec, URBG& mt)
+{
+    auto const colon = spec.find(':');
+    auto const kind = spec.substr(0, colon);
+    std::vector<double> parameters;
+    if (colon != std::string_view::npos)
+        for (auto rest = spec.substr(colon + 1); !rest.empty();) {
+            auto const comma = std::min(rest.find(','), std::size(rest));
+            parameters.push_back(std::stod(std::string{rest.substr(0, comma)}));
+            rest.remove_prefix(std::min(comma + 1, std::size(rest)));
+        }
+    auto expect = [&](std::size_t nb_parameters) {
+        if (std::size(parameters) != nb_parameters)
+            throw std::runtime_error("Wrong number of parameters for the generator \"" + std::string{kind} + "\".");
+    };
+    auto const size = [&](std::size_t i) { return static_cast<std::size_t>(parameters[i]); };
+    auto const vertex = [&](std::size_t i) { return static_cast<node_t>(parameters[i]); };
+
+    if (kind == "er") { expect(2); return erdos_renyi(vertex(0), parameters[1], mt); }
+    if (kind == "planted") { expect(3); return planted_cut(vertex(0), size(1), size(2), mt); }
+    if (kind == "regular") { expect(2); return random_regular(vertex(0), size(1), mt); }
+    if (kind == "rmat") {
+        if (std::size(parameters) == 2) return rmat<node_t>(size(0), size(1), mt);
+        expect(5);
+        return rmat<node_t>(size(0), size(1), mt, parameters[2], parameters[3], parameters[4]);
+    }
+    if (kind == "grid") { expect(2); return grid(vertex(0), vertex(1)); }
+    throw std::runtime_error("Unknown generator \"" + std::string{kind} + "\".");
+}
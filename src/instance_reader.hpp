@@ -1,38 +1,169 @@
 #pragma once
 
+#include <algorithm>
+#include <charconv>
+#include <cstdint>
+#include <cstring>
 #include <fstream>
-#include <sstream>
+#include <limits>
+#include <optional>
+#include <stdexcept>
 #include <string>
 #include <vector>
 #include "karger.hpp"
 
 
+/* Reads an instance in the DIMACS .col format: comment lines, a problem line "p edge n m" then the
+m edges "e u v", whose vertices are numbered from 1. The file is read at once and parsed with
+std::from_chars, each line being validated as it is parsed: the problem line must come once and
+before the edges, vertices must be in [1, n] (a single unsigned comparison each) and there must be
+m edges. Errors tell the line and the column of the problem. */
 template <typename node_t>
 EdgesVectorGraph<node_t> read_col_instance(std::string_view file) {
-    EdgesVectorGraph<node_t> graph;
-    std::ifstream instance;
-    instance.open(file.data());
+    std::ifstream instance{file.data(), std::ios::binary};
     if (!instance) throw std::runtime_error("Such instance doesn't exist.");
-    for (std::string line; std::getline(instance, line);)
-    {
-        std::istringstream input(line);
-        switch(line[0]) {
-            case 'p':
-                input.ignore(6);
-                std::size_t m;
-                input >> graph.n >> m;
-                graph.edges.reserve(m);
+    instance.seekg(0, std::ios::end);
+    std::string content(static_cast<std::size_t>(instance.tellg()), '\0');
+    instance.seekg(0);
+    instance.read(content.data(), std::size(content));
+
+    char const* const first = content.data();
+    char const* const last = first + std::size(content);
+    std::size_t line_number = 1;
+    char const* line_start = first;
+    auto error = [&](char const* position, std::string const& what) {
+        return std::runtime_error(std::string{file} + ':' + std::to_string(line_number) + ':'
+            + std::to_string(position - line_start + 1) + ": " + what);
+    };
+    auto skip_blanks = [&](char const*& p) { while (p != last && (*p == ' ' || *p == '\t')) ++p; };
+    auto number = [&](char const*& p) {
+        skip_blanks(p);
+        std::uint64_t value;
+        auto const [end, ec] = std::from_chars(p, last, value);
+        if (ec != std::errc{}) throw error(p, "expected a number");
+        p = end;
+        return value;
+    };
+
+    EdgesVectorGraph<node_t> graph{0, {}};
+    std::optional<std::uint64_t> nb_edges; // given by the problem line
+    for (char const* p = first; p != last; ++line_number) {
+        line_start = p;
+        auto line_end = static_cast<char const*>(std::memchr(p, '\n', last - p));
+        if (!line_end) line_end = last;
+        switch (*p) {
+            case 'p': {
+                if (nb_edges) throw error(p, "second problem line");
+                ++p;
+                skip_blanks(p);
+                while (p != line_end && *p != ' ' && *p != '\t') ++p; // the format, "edge" or "col"
+                auto const n_at = p;
+                auto const n = number(p);
+                if (n > std::numeric_limits<node_t>::max()) throw error(n_at, "too many vertices for node_t");
+                graph.n = static_cast<node_t>(n);
+                nb_edges = number(p);
+                graph.edges.reserve(std::min<std::uint64_t>(*nb_edges, std::size(content) / 6)); // "e u v" lines
                 break;
-            case 'e':
-                input.ignore(2);
-                Edge<node_t> edge;
-                input >> edge.tail >> edge.head;
-                --edge.tail; --edge.head; // instance files starting vertex is 1
-                graph.edges.push_back(std::move(edge));
+            }
+            case 'e': {
+                if (!nb_edges) throw error(p, "edge before the problem line");
+                ++p;
+                skip_blanks(p);
+                auto const tail_at = p;
+                auto const tail = number(p);
+                skip_blanks(p);
+                auto const head_at = p;
+                auto const head = number(p);
+                if (tail - 1 >= graph.n || head - 1 >= graph.n) // also catches 0
+                    throw error(tail - 1 >= graph.n ? tail_at : head_at, "vertex out of [1, " + std::to_string(graph.n) + "]");
+                graph.edges.push_back({static_cast<node_t>(tail - 1), static_cast<node_t>(head - 1)}); // instance files starting vertex is 1
                 break;
-            default:
+            }
+            default: // comments and other lines
+                p = line_end;
                 break;
         }
+        while (p != line_end && (*p == ' ' || *p == '\t' || *p == '\r')) ++p;
+        if (p != line_end) throw error(p, "unexpected character");
+        p = line_end == last ? last : line_end + 1;
     }
+    if (!nb_edges) throw std::runtime_error(std::string{file} + ": no problem line.");
+    if (std::size(graph.edges) != *nb_edges)
+        throw std::runtime_error(std::string{file} + ": " + std::to_string(std::size(graph.edges)) + " edges listed, "
+            + std::to_string(*nb_edges) + " expected by the problem line.");
     return graph;
 }
+
+
+/* Binary instance format, much faster to read than a .col file for large generated graphs: the
+magic bytes, the number of vertices and of edges as 64-bit integers, then the edges as pairs of
+32-bit vertex indices (starting at 0), all in the byte order of the machine. Reading checks that
+the vertices are below n in the loop copying the edges (OR-ing the comparisons of a chunk, whose
+edges are only searched for the faulty one if any), unless the file is trusted. */
+inline constexpr char binary_instance_magic[8] = {'K', 'A', 'R', 'G', 'E', 'R', 'B', '1'};
+
+template <typename node_t>
+void write_binary_instance(EdgesVectorGraph<node_t> const& graph, std::string_view file)
+{
+    if (graph.n > std::numeric_limits<std::uint32_t>::max())
+        throw std::runtime_error("Too many vertices for the binary format.");
+    std::ofstream output{file.data(), std::ios::binary};
+    std::uint64_t const header[2] = {graph.n, std::size(graph.edges)};
+    output.write(binary_instance_magic, sizeof(binary_instance_magic));
+    output.write(reinterpret_cast<char const*>(header), sizeof(header));
+    std::vector<std::uint32_t> buffer;
+    for (std::size_t first = 0; first < std::size(graph.edges); first += 1 << 16) {
+        buffer.clear();
+        for (std::size_t i = first; i < std::min(std::size(graph.edges), first + (1 << 16)); ++i)
+            buffer.insert(end(buffer), {static_cast<std::uint32_t>(graph.edges[i].tail), static_cast<std::uint32_t>(graph.edges[i].head)});
+        output.write(reinterpret_cast<char const*>(buffer.data()), std::size(buffer) * sizeof(std::uint32_t));
+    }
+    if (!output.flush()) throw std::runtime_error("Cannot write the instance.");
+}
+
+template <typename node_t>
+EdgesVectorGraph<node_t> read_binary_instance(std::string_view file, bool trusted = false)
+{
+    std::ifstream input{file.data(), std::ios::binary};
+    if (!input) throw std::runtime_error("Such instance doesn't exist.");
+    char magic[sizeof(binary_instance_magic)];
+    std::uint64_t header[2];
+    input.read(magic, sizeof(magic));
+    input.read(reinterpret_cast<char*>(header), sizeof(header));
+    if (!input || std::memcmp(magic, binary_instance_magic, sizeof(magic)) != 0)
+        throw std::runtime_error("Not a binary instance file.");
+    if (header[0] > std::numeric_limits<node_t>::max()) throw std::runtime_error("Too many vertices for node_t.");
+    EdgesVectorGraph<node_t> graph{static_cast<node_t>(header[0]), {}};
+    graph.edges.reserve(header[1]);
+    std::vector<std::uint32_t> buffer;
+    for (std::uint64_t first = 0; first < header[1]; first += 1 << 16) {
+        buffer.resize(2 * std::min<std::uint64_t>(header[1] - first, 1 << 16));
+        input.read(reinterpret_cast<char*>(buffer.data()), std::size(buffer) * sizeof(std::uint32_t));
+        if (!input) throw std::runtime_error("Truncated binary instance file.");
+        bool out_of_range = false;
+        for (std::size_t i = 0; i < std::size(buffer); i += 2) {
+            if (!trusted) out_of_range |= (buffer[i] >= header[0]) | (buffer[i + 1] >= header[0]);
+            graph.edges.push_back({static_cast<node_t>(buffer[i]), static_cast<node_t>(buffer[i + 1])});
+        }
+        if (out_of_range) {
+            auto const i = std::ranges::find_if(buffer, [&](auto u) { return u >= header[0]; }) - begin(buffer);
+            throw std::runtime_error(std::string{file} + ": vertex " + std::to_string(buffer[i]) + " of edge "
+                + std::to_string(first + i / 2) + " out of [0, " + std::to_string(header[0]) + ").");
+        }
+    }
+    return graph;
+}
+
+
+/* Reads an instance in the binary format if the file starts with its magic bytes, in the .col
+format otherwise. */
+template <typename node_t>
+EdgesVectorGraph<node_t> read_instance(std::string_view file, bool trusted = false)
+{
+    std::ifstream input{file.data(), std::ios::binary};
+    if (!input) throw std::runtime_error("Such instance doesn't exist.");
+    char magic[sizeof(binary_instance_magic)] = {};
+    input.read(magic, sizeof(magic));
+    if (std::memcmp(magic, binary_instance_magic, sizeof(magic)) == 0) return read_binary_instance<node_t>(file, trusted);
+    return read_col_instance<node_t>(file);
+}
@@ -1,10 +1,19 @@
 #pragma once
 
 #include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
 #include <cmath>
+#include <cstdint>
+#include <iterator>
+#include <limits>
+#include <numeric>
+#include <optional>
 #include <random>
 #include <ranges>
 #include <stack>
+#include <stdexcept>
 #include <vector>
 
 
@@ -13,6 +22,32 @@ auto& prng_engine() {
     return engine;
 } 
 
+/* SplitMix64 generator [Steele et al., Fast Splittable Pseudorandom Number Generators, 2014]. Its
+state is a single word, so that it is seeded for free, unlike std::mt19937 and its 624 words: it is
+meant for the many short random streams which have to be replayed from their seed. */
+struct SplitMix64
+{
+    using result_type = std::uint64_t;
+    std::uint64_t state;
+
+    static constexpr result_type min() { return 0; }
+    static constexpr result_type max() { return std::numeric_limits<result_type>::max(); }
+    constexpr result_type operator()() {
+        auto z = state += 0x9e3779b97f4a7c15;
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111eb;
+        return z ^ (z >> 31);
+    }
+};
+
+/* Reseeds the engine of the calling thread for the given trial of a campaign, so that each trial
+draws the same numbers whatever the thread or the process running it. */
+void seed_trial(std::uint64_t seed, std::uint64_t trial) {
+    std::seed_seq sequence{static_cast<std::uint32_t>(seed), static_cast<std::uint32_t>(seed >> 32),
+                           static_cast<std::uint32_t>(trial), static_cast<std::uint32_t>(trial >> 32)};
+    prng_engine().seed(sequence);
+}
+
 
 template <typename node_t>
 struct Edge { node_t tail, head; };
@@ -50,62 +85,467 @@ struct UnionFind
         return root;
     }
 
-    void merge(T x, T y) {
+    /* Returns true if x and y were in two subsets, false if they already were in the same one. */
+    bool merge(T x, T y) {
         auto const i = find(x); auto const j = find(y);
-        if (i == j) return;
+        if (i == j) return false;
         if (subsets[i].size < subsets[j].size) { subsets[i].id = j; subsets[j].size += subsets[i].size; }
         else                                   { subsets[j].id = i; subsets[i].size += subsets[j].size; }
         --nb_subsets;
+        return true;
     }
 
     bool connected(T x, T y) { return find(x) == find(y); }
 };
 
 
+/* A Union-Find data structure which any number of threads can update at once, without locks
+[Jayanti & Tarjan, A Randomized Concurrent Algorithm for Disjoint Set Union, 2016]. A root is linked
+under another with a CAS, always the one of lower priority under the one of higher priority (a hash
+of their index, which acts as a random order), so that the parent of a vertex always has a higher
+priority than itself: the structure stays a forest whatever the interleaving of the threads, and its
+trees are shallow. find() splits the path it follows, each vertex being pointed to its grandparent
+by a CAS which may fail harmlessly, and is wait-free. The parents are only read and written relaxed:
+they are indices and publish no other data. */
+template <typename T>
+struct ConcurrentUnionFind
+{
+    std::vector<std::atomic<T>> parents;
+    std::atomic<T> nb_subsets;
+
+    ConcurrentUnionFind(T n) : parents(n), nb_subsets{n} {
+        for (T i = 0; i < n; ++i) parents[i].store(i, std::memory_order_relaxed);
+    }
+
+    T find(T x) {
+        for (;;) {
+            auto parent = parents[x].load(std::memory_order_relaxed);
+            if (parent == x) return x;
+            auto const grandparent = parents[parent].load(std::memory_order_relaxed);
+            if (grandparent != parent) parents[x].compare_exchange_weak(parent, grandparent, std::memory_order_relaxed);
+            x = parent; // the current parent of x on failure, an ancestor all the same
+        }
+    }
+
+    /* Returns true if x and y were in two subsets, which this call merged. */
+    bool merge(T x, T y) {
+        for (;;) {
+            x = find(x); y = find(y);
+            if (x == y) return false;
+            if (precedes(x, y)) std::swap(x, y);
+            if (auto root = y; parents[y].compare_exchange_strong(root, x, std::memory_order_relaxed)) {
+                nb_subsets.fetch_sub(1, std::memory_order_relaxed);
+                return true;
+            }
+        }
+    }
+
+    bool connected(T x, T y) {
+        for (;;) {
+            x = find(x); y = find(y);
+            if (x == y) return true;
+            if (parents[x].load(std::memory_order_relaxed) == x) return false; // still a root after y was found
+        }
+    }
+
+    /* The same partition in a sequential structure, once the updates are over. */
+    UnionFind<T> to_union_find() {
+        UnionFind<T> uf{0};
+        uf.subsets.resize(std::size(parents)); // sizes of zero, counted below
+        for (T i = 0; i < std::size(parents); ++i) {
+            uf.subsets[i].id = find(i);
+            ++uf.subsets[uf.subsets[i].id].size;
+        }
+        uf.nb_subsets = nb_subsets.load(std::memory_order_relaxed);
+        return uf;
+    }
+
+private:
+    static bool precedes(T x, T y) {
+        auto priority = [](std::uint64_t z) { return SplitMix64{z}(); };
+        auto const p = priority(x), q = priority(y);
+        return p != q ? p < q : x < y;
+    }
+};
+
+
 /* A data structure representing a cut of a graph. */
 template <typename node_t>
 struct GraphCut
 {
     std::size_t cut_size;
     UnionFind<node_t> uf; // used to identify the two partitions of nodes
+    std::vector<Edge<node_t>> cut_edges = {}; // the edges crossing the cut, if asked to the algorithm
 
     bool operator<(GraphCut const& other) const { return cut_size < other.cut_size; }
 
     auto get_partitions() const {
+        auto partitions_uf = uf; // find() compresses paths, hence the copy
+        auto const p = partitions_uf.find(0);
         std::vector<node_t> P, Q;
-        P.reserve(uf.subsets[0].size); Q.reserve(std::size(uf.subsets) - std::size(P));
+        P.reserve(partitions_uf.subsets[p].size); Q.reserve(std::size(uf.subsets) - P.capacity());
         for (node_t i = 0; i < std::size(uf.subsets); ++i)
-            uf.subsets[i].id == uf.subsets[0].id ? P.push_back(i) : Q.push_back(i);
+            partitions_uf.find(i) == p ? P.push_back(i) : Q.push_back(i);
         return std::array{P, Q};
     }
+
+    /* Returns the side (0 or 1) of each vertex, vertex 0 being on side 0. */
+    auto get_sides() const {
+        auto sides_uf = uf;
+        auto const p = sides_uf.find(0);
+        std::vector<std::uint8_t> sides(std::size(uf.subsets));
+        for (node_t i = 0; i < std::size(uf.subsets); ++i) sides[i] = sides_uf.find(i) != p;
+        return sides;
+    }
 };
 
 
+/* Rebuilds a cut from the side (0 or 1) of each vertex. */
+template <typename node_t>
+GraphCut<node_t> cut_from_sides(std::size_t cut_size, std::uint8_t const* sides, node_t n)
+{
+    UnionFind<node_t> uf{n};
+    std::optional<node_t> representatives[2];
+    for (node_t u = 0; u < n; ++u) {
+        auto& representative = representatives[sides[u]];
+        if (representative) uf.merge(u, *representative);
+        else representative = u;
+    }
+    return {cut_size, std::move(uf)};
+}
+
+
+/* Returns the number of edges of the graph crossing the given cut, i.e. the size of this cut in
+the graph, which may differ from the one the cut was computed on (e.g. a sampled graph). */
+template <typename node_t>
+std::size_t crossing_edges_count(EdgesVectorGraph<node_t> const& graph, GraphCut<node_t> const& cut)
+{
+    auto const sides = cut.get_sides();
+    return std::ranges::count_if(graph.edges, [&](auto e) { return sides[e.tail] != sides[e.head]; });
+}
+
+
+/* Returns the edges of the graph crossing the given cut, for the cuts whose edges weren't kept by
+the algorithm. */
+template <typename node_t>
+std::vector<Edge<node_t>> crossing_edges(EdgesVectorGraph<node_t> const& graph, GraphCut<node_t> const& cut)
+{
+    auto const sides = cut.get_sides();
+    std::vector<Edge<node_t>> edges;
+    std::ranges::copy_if(graph.edges, std::back_inserter(edges), [&](auto e) { return sides[e.tail] != sides[e.head]; });
+    return edges;
+}
+
+
+/* Exact minimum cut of a graph with K vertices given by its symmetric weight matrix (the number of
+edges between each pair of vertices, self-loops excluded). The 2^(K-1) - 1 cuts are enumerated in
+Gray code order, the vertex K-1 always staying out of the side, so that each step only moves one
+vertex across the cut and updates its size in O(K). Returns the size of a minimum cut and the
+bitmask of its side. */
+template <std::size_t K>
+constexpr auto exact_small_cut(std::array<std::array<std::size_t, K>, K> const& weights)
+{
+    static_assert(2 <= K && K <= 16, "exhaustive enumeration is meant for tiny graphs only");
+    std::array<std::size_t, K> degrees{};
+    for (std::size_t u = 0; u < K; ++u)
+        for (std::size_t v = 0; v < K; ++v) degrees[u] += weights[u][v];
+
+    struct { std::size_t size; std::uint32_t side; } best{std::numeric_limits<std::size_t>::max(), 0};
+    std::size_t size = 0;
+    for (std::uint32_t i = 1, side = 0; i < (1u << (K - 1)); ++i) {
+        auto const v = std::countr_zero(i); // vertex flipped from gray(i - 1) to gray(i)
+        std::size_t w = 0; // number of edges between v and the other vertices of the side
+        for (std::size_t u = 0; u < K; ++u)
+            if (side >> u & 1) w += weights[v][u];
+        size = side >> v & 1 ? size + 2 * w - degrees[v] : size + degrees[v] - 2 * w;
+        side ^= 1u << v;
+        if (size < best.size) best = {size, side};
+    }
+    return best;
+}
+
+
+/* Builds the cut found by exact_small_cut() on K super-vertices, each given by one of its vertices,
+by merging the subsets of the Union-Find structure on each side. */
+template <std::size_t K, typename node_t, typename Vertices>
+GraphCut<node_t> make_small_cut(std::size_t size, std::uint32_t side, Vertices const& vertices, UnionFind<node_t> uf)
+{
+    auto const representative = std::countr_zero(side);
+    for (std::size_t i = 0; i < K - 1; ++i)
+        uf.merge(vertices[i], vertices[side >> i & 1 ? representative : K - 1]);
+    return {size, std::move(uf)};
+}
+
+
+/* Exact minimum cut of a contracted graph with K super-vertices, which are the subsets of the given
+Union-Find structure. Super-vertices are relabeled between 0 and K-1 to fill a weight matrix on
+which the cuts are enumerated. The cut is only built if its size is below the given bound. */
+template <std::size_t K, typename node_t, typename Edges>
+std::optional<GraphCut<node_t>> exact_contracted_cut(Edges const& edges, UnionFind<node_t> uf,
+    std::size_t bound = std::numeric_limits<std::size_t>::max())
+{
+    std::array<node_t, K> roots;
+    std::size_t k = 0;
+    auto label = [&](node_t root) {
+        std::size_t i = 0;
+        while (i < k && roots[i] != root) ++i;
+        if (i == k) roots[k++] = root;
+        return i;
+    };
+
+    std::array<std::array<std::size_t, K>, K> weights{};
+    for (auto const& e : edges) {
+        auto const u = uf.find(e.tail), v = uf.find(e.head);
+        if (u == v) continue;
+        auto const i = label(u), j = label(v);
+        ++weights[i][j]; ++weights[j][i];
+    }
+    for (node_t u = 0; k < K; ++u) // some super-vertices are isolated
+        if (uf.find(u) == u) label(u);
+
+    auto const [size, side] = exact_small_cut(weights);
+    if (size >= bound) return std::nullopt;
+    return make_small_cut<K>(size, side, roots, std::move(uf));
+}
+
+
+/* Calls f.template operator()<K>() with K = n, for the numbers of vertices handled by the exact
+cut kernels. */
+constexpr std::size_t EXACT_CUT_MAX_VERTICES = 8;
+
+template <typename F>
+decltype(auto) with_small_size(std::size_t n, F&& f)
+{
+    switch (n) {
+        case 2: return f.template operator()<2>();
+        case 3: return f.template operator()<3>();
+        case 4: return f.template operator()<4>();
+        case 5: return f.template operator()<5>();
+        case 6: return f.template operator()<6>();
+        case 7: return f.template operator()<7>();
+        case 8: return f.template operator()<8>();
+        default: throw std::invalid_argument("Too many vertices for an exact cut.");
+    }
+}
+
+template <typename node_t, typename Edges>
+std::optional<GraphCut<node_t>> exact_contracted_cut(node_t n, Edges const& edges, UnionFind<node_t> uf,
+    std::size_t bound = std::numeric_limits<std::size_t>::max())
+{
+    return with_small_size(n, [&]<std::size_t K>() { return exact_contracted_cut<K>(edges, std::move(uf), bound); });
+}
+
+
+/* Counts a self-loop drawn by Karger's contraction, and tells whether the nb_left edges left are
+worth compacting: the self-loops drawn since the last compaction are at least half of its nb_draws
+draws and a quarter of the edges left, so that they pay for the pass over these edges. */
+inline bool count_self_loop(std::size_t& nb_loops, std::size_t nb_draws, std::size_t nb_left)
+{
+    ++nb_loops;
+    return 4 * nb_loops >= nb_left && 2 * nb_loops >= nb_draws;
+}
+
+
 /* Karger's contraction algorithm in O(n + mα(n)) using an Union-Find data structure to keep track
 of merged vertices. The graph is assumed to be connected and nodes indexed between 0 and n-1. Repeat
 this function C(n,2)*log(n) = n*(n-1)/2*log(n) for high probability of obtaining the minimum global
-cut. The graph isn't per se modifed, only its vector of edges is shuffled. */
+cut. The graph isn't per se modifed, only its vector of edges is shuffled. The edges left after the
+contraction are those of the cut along with self-loops: with with_cut_edges, they are partitioned
+instead of counted so that the crossing ones are returned at no extra cost.
+Late in the contraction, most of the edges left have become self-loops, on which draws and finds are
+wasted: once the self-loops drawn since the last compaction are a quarter of the edges left, and at
+least half of the draws, the self-loops are moved behind the edges left (count_self_loop()). Drawing
+among the others is the same as drawing among all of them until one isn't a self-loop, hence the
+same distribution of cuts. */
 template <typename node_t>
-GraphCut<node_t> karger_union_find(EdgesVectorGraph<node_t>& graph)
+GraphCut<node_t> karger_union_find(EdgesVectorGraph<node_t>& graph, bool with_cut_edges = false)
 {
     auto& mt = prng_engine();
     UnionFind uf{graph.n};
-    auto start = begin(graph.edges);
-    for (int m = size(graph.edges) - 1; uf.nb_subsets != 2; ++start, --m) {
-        std::iter_swap(start, start + std::uniform_int_distribution<>{0, m}(mt));
-        uf.merge(start->tail, start->head);
+    auto const crossing = [&](auto e) { return !uf.connected(e.tail, e.head); };
+    auto start = begin(graph.edges), last = end(graph.edges); // the edges left
+    for (std::size_t nb_draws = 0, nb_loops = 0; uf.nb_subsets != 2 && start != last; ++start) {
+        std::iter_swap(start, start + std::uniform_int_distribution<std::size_t>{0, static_cast<std::size_t>(last - start) - 1}(mt));
+        ++nb_draws;
+        if (!uf.merge(start->tail, start->head) && count_self_loop(nb_loops, nb_draws, last - start)) {
+            last = std::partition(start + 1, last, crossing);
+            nb_draws = nb_loops = 0;
+        }
+    }
+    if (with_cut_edges) {
+        auto const cut_end = std::partition(start, last, crossing);
+        return {static_cast<std::size_t>(cut_end - start), std::move(uf), {start, cut_end}};
+    }
+    return {(std::size_t) std::count_if(start, last, crossing), std::move(uf)};
+}
+
+
+/* Karger's contraction of edges taken by 32-bit indices, until uf has nb_subsets subsets or no edge
+is left: the indices are shuffled in a buffer kept by the calling thread from one call to the next,
+reset to the identity at each call so that the contraction only depends on the draws of mt. Self-
+loops are compacted away as in karger_union_find(). Returns the indices of the edges left, which
+cross the subsets of uf or are self-loops, valid until the next call on the same thread. */
+template <typename node_t, typename Engine>
+auto contract_indices(std::vector<Edge<node_t>> const& edges, UnionFind<node_t>& uf, node_t nb_subsets, Engine& mt)
+{
+    if (std::size(edges) > std::numeric_limits<std::uint32_t>::max())
+        throw std::length_error("Too many edges for 32-bit indices.");
+    thread_local static std::vector<std::uint32_t> indices;
+    indices.resize(std::size(edges));
+    std::iota(begin(indices), end(indices), std::uint32_t{0});
+
+    auto const crossing = [&](auto i) { return !uf.connected(edges[i].tail, edges[i].head); };
+    auto start = begin(indices), last = end(indices);
+    for (std::size_t nb_draws = 0, nb_loops = 0; uf.nb_subsets != nb_subsets && start != last; ++start) {
+        std::iter_swap(start, start + std::uniform_int_distribution<std::size_t>{0, static_cast<std::size_t>(last - start) - 1}(mt));
+        ++nb_draws;
+        auto const e = edges[*start];
+        if (!uf.merge(e.tail, e.head) && count_self_loop(nb_loops, nb_draws, last - start)) {
+            last = std::partition(start + 1, last, crossing);
+            nb_draws = nb_loops = 0;
+        }
+    }
+    return std::ranges::subrange(start, last);
+}
+
+
+/* Same as above on a graph taken by const reference, which any number of threads can share: the
+contraction shuffles 32-bit edge indices instead of the edges (contract_indices()), so that the cut
+only depends on the draws of the random engine (it is the one the function above finds on edges in
+this order), at the cost of an O(m) pass which the count of the cut's edges makes anyway. */
+template <typename node_t>
+GraphCut<node_t> karger_union_find(EdgesVectorGraph<node_t> const& graph, bool with_cut_edges = false)
+{
+    UnionFind uf{graph.n};
+    std::size_t cut_size = 0;
+    std::vector<Edge<node_t>> cut_edges;
+    for (auto i : contract_indices(graph.edges, uf, node_t{2}, prng_engine()))
+        if (auto const e = graph.edges[i]; !uf.connected(e.tail, e.head)) {
+            ++cut_size;
+            if (with_cut_edges) cut_edges.push_back(e);
+        }
+    return {cut_size, std::move(uf), std::move(cut_edges)};
+}
+
+
+/* Returns true if the graph is connected, i.e. if its minimum cut isn't empty. */
+template <typename node_t>
+bool is_connected(EdgesVectorGraph<node_t> const& graph)
+{
+    UnionFind uf{graph.n};
+    for (auto e : graph.edges) uf.merge(e.tail, e.head);
+    return uf.nb_subsets <= 1;
+}
+
+
+/* Returns the cut separating a vertex of minimum degree from the others, an upper bound of the
+minimum cut computed in O(n + m). */
+template <typename node_t>
+GraphCut<node_t> minimum_degree_cut(EdgesVectorGraph<node_t> const& graph)
+{
+    std::vector<std::size_t> degrees(graph.n);
+    for (auto e : graph.edges)
+        if (e.tail != e.head) { ++degrees[e.tail]; ++degrees[e.head]; }
+    node_t const r = std::ranges::min_element(degrees) - begin(degrees);
+    UnionFind uf{graph.n};
+    for (node_t u = 0; u < graph.n; ++u)
+        if (u != r) uf.merge(u, r == 0);
+    return {degrees[r], std::move(uf)};
+}
+
+
+/* Shape of the Karger-Stein recursion: a graph with more than leaf_size super-vertices is contracted
+nb_children times independently down to 1 + ⌈n·contraction_ratio⌉ super-vertices, and the leaves
+are solved exactly (at most EXACT_CUT_MAX_VERTICES super-vertices) or contracted down to two
+super-vertices as in Karger's algorithm. The defaults are those of [Karger & Stein]: two children
+contracted to 1 + ⌈n/√2⌉ super-vertices, with exact leaves of at most 6 super-vertices.
+
+With a shared_ratio below 1, the children share the beginning of their contraction: the graph is
+first contracted once down to ⌈n·shared_ratio⌉ super-vertices, and the children are contracted from
+there. The shared contraction is a prefix of a random contraction order like any other, so each child
+is still a random contraction of the graph, but the children are no longer independent: they all
+miss the minimum cut if the shared prefix contracts one of its edges. In exchange, the edges of the
+graph are shuffled once for the shared part instead of once per child, and the children start from
+a smaller edge list.
+
+With a recompute_interval k > 0, the pending graphs aren't stored: the recursion only keeps the
+graphs of one node out of k along its current path, and contracts the others again from their seed
+when it comes back to them: about depth/k graphs are kept instead of depth·(nb_children - 1)
+pending ones, for up to k - 1 more contractions each time the recursion comes back to a node. */
+enum class LeafSolver { exact, contraction };
+
+struct KargerSteinParameters
+{
+    std::size_t nb_children = 2;
+    double contraction_ratio = 0.70710678118654752; // 1/√2
+    std::size_t leaf_size = 6;
+    LeafSolver leaf_solver = LeafSolver::exact;
+    double shared_ratio = 1; // no shared contraction
+    std::size_t recompute_interval = 0; // pending graphs are stored
+
+    void validate() const {
+        if (nb_children < 1) throw std::invalid_argument("Karger-Stein needs at least one child per graph.");
+        if (!(0 < contraction_ratio && contraction_ratio < 1)) throw std::invalid_argument("The contraction ratio must be in (0, 1).");
+        if (leaf_size < 2) throw std::invalid_argument("Leaves have at least two super-vertices.");
+        if (leaf_solver == LeafSolver::exact && leaf_size > EXACT_CUT_MAX_VERTICES)
+            throw std::invalid_argument("Too many vertices for exact leaves.");
+        if (!(0 < shared_ratio && shared_ratio <= 1)) throw std::invalid_argument("The shared ratio must be in (0, 1].");
+    }
+
+    /* The recursion has about n^e leaves for this exponent e = log(nb_children) / log(1/ratio): at
+    most n² (a run in O(n² log n) like the original algorithm) when nb_children·ratio² <= 1. */
+    double leaves_exponent() const { return std::log(double(nb_children)) / -std::log(contraction_ratio); }
+
+    /* Number of super-vertices the children of a graph with n > leaf_size of them have. */
+    std::size_t target(std::size_t n) const {
+        return std::clamp<std::size_t>(1 + std::ceil(n * contraction_ratio), 2, n - 1);
+    }
+
+    /* Number of super-vertices the shared contraction of a graph with n of them goes down to (n if
+    there is none). */
+    std::size_t shared_target(std::size_t n) const {
+        return std::clamp<std::size_t>(std::ceil(n * shared_ratio), target(n) + 1, n);
     }
-    return {(std::size_t) std::count_if(start, end(graph.edges), [&](auto e)
-        { return !uf.connected(e.tail, e.head); }), std::move(uf)};
+};
+
+
+/* Lower bound of the probability that a Karger-Stein run with the given parameters finds a given
+minimum cut of a graph with n vertices: contracting n super-vertices down to t keeps the cut with
+probability at least t(t - 1) / (n(n - 1)), and each child has the same chance of finding it once the
+shared contraction, if any, has kept it. */
+inline double karger_stein_success_probability(std::size_t n, KargerSteinParameters const& parameters)
+{
+    if (n <= parameters.leaf_size || n < 3)
+        return parameters.leaf_solver == LeafSolver::exact || n < 3 ? 1 : 2 / (n * (n - 1.0));
+    auto const survival = [](double from, double to) { return to * (to - 1) / (from * (from - 1)); };
+    auto const t = parameters.target(n), s = parameters.shared_target(n);
+    return survival(n, s) * (1 - std::pow(1 - survival(s, t) * karger_stein_success_probability(t, parameters), parameters.nb_children));
 }
 
 
 /* Kargen-Stein's contraction recursive algorithm. Instead of using a straighforward recursion, we
 keep the intermediate graphs to contract in a stack. Repeat this function log²(n) for high probabili
--ty of obtaining the minimum global cut. */
+-ty of obtaining the minimum global cut. When runs are made concurrently, the size of the best cut
+found by all of them (the incumbent) can be shared so that a leaf no better than it isn't turned
+into a cut. A run whose leaves are all pruned returns a cut of infinite size.
+
+The search is bounded. The minimum degree cut is a first upper bound, which spares building the
+cuts of most leaves when the minimum cut is a single vertex. Counting the degrees of the super-
+vertices of every intermediate graph would cost about 20% of the run for little gain, so it is only
+done on the input graph. No cut of a contracted graph is smaller than the minimum cut of the input
+graph, which is at least 1 when it is connected: once the best cut reaches this lower bound, all the
+pending graphs are useless and the run stops.
+
+With with_cut_edges, the edges of the cut are taken from the few edges left in the leaf it comes
+from, or from the input graph if it is the minimum degree cut. The shape of the recursion is given
+by the parameters, whose defaults are those of the original algorithm. */
 template <typename node_t>
-auto karger_stein_union_find(EdgesVectorGraph<node_t> const& input_graph)
+GraphCut<node_t> karger_stein_union_find(EdgesVectorGraph<node_t> const& input_graph,
+    std::atomic<std::size_t> const* incumbent = nullptr, bool with_cut_edges = false,
+    KargerSteinParameters const& parameters = {})
 {
+    parameters.validate();
+
     /* A data structure to hold an intermediate contracted graph state. The Union-Find structure
     is used to keep track of the merged nodes. */ 
     struct ContractedGraph : EdgesVectorGraph<node_t> { UnionFind<node_t> uf; };
@@ -126,28 +566,104 @@ auto karger_stein_union_find(EdgesVectorGraph<node_t> const& input_graph)
         return ContractedGraph{nb_vertices, std::move(edges), std::move(uf)};
     };
 
-    /* Returns the cut represented by an intermediate contracted graph. The given graph is supposed
-    to have no self-loops and to have two nodes (components). */
-    auto cut = [](ContractedGraph&& graph){ return GraphCut{std::size(graph.edges), graph.uf}; };
-    
-    constexpr double INV_SQRT_2 = 1.0 / std::sqrt(2);
-    GraphCut<node_t> best_minimum_cut{input_graph.n, {{}}};
-    std::stack<ContractedGraph, std::vector<ContractedGraph>> graphs;
-    graphs.push({input_graph.n, input_graph.edges, {input_graph.n}});
-
-    while (!graphs.empty()) // algorithm's main loop
-    {
-        auto graph = graphs.top();
-        graphs.pop();
-
-        if (graph.n <= 6) {
-            best_minimum_cut = std::min(best_minimum_cut, cut(contract(graph, 2)));
-        } else {
-            node_t t = 1 + std::ceil(graph.n * INV_SQRT_2);
-            graphs.push(contract(graph, t));
-            graphs.push(contract(graph, t));
+    GraphCut<node_t> best_minimum_cut{std::numeric_limits<std::size_t>::max(), {{}}};
+    auto bound = [&] {
+        return std::min(best_minimum_cut.cut_size,
+            incumbent ? incumbent->load(std::memory_order_relaxed) : std::numeric_limits<std::size_t>::max());
+    };
+    std::size_t const lower_bound = is_connected(input_graph);
+    if (input_graph.n > 1)
+        if (auto cut = minimum_degree_cut(input_graph); cut.cut_size < bound()) best_minimum_cut = std::move(cut);
+
+    auto solve_leaf = [&](ContractedGraph& graph) { // leaves aren't split any further
+        if (parameters.leaf_solver == LeafSolver::contraction) { // the edges left cross the cut
+            auto leaf = graph.n > 2 ? contract(graph, 2) : std::move(graph);
+            if (std::size(leaf.edges) >= bound()) return;
+            best_minimum_cut = {std::size(leaf.edges), std::move(leaf.uf)};
+            if (with_cut_edges) best_minimum_cut.cut_edges = std::move(leaf.edges);
+        } else if (auto cut = exact_contracted_cut(graph.n, graph.edges, std::move(graph.uf), bound())) {
+            if (with_cut_edges)
+                for (auto e : graph.edges)
+                    if (!cut->uf.connected(e.tail, e.head)) cut->cut_edges.push_back(e);
+            best_minimum_cut = std::move(*cut);
+        }
+    };
+
+    if (!parameters.recompute_interval) {
+        std::stack<ContractedGraph, std::vector<ContractedGraph>> graphs;
+        graphs.push({input_graph.n, input_graph.edges, {input_graph.n}});
+
+        while (!graphs.empty() && bound() > lower_bound) // algorithm's main loop
+        {
+            auto graph = std::move(graphs.top());
+            graphs.pop();
+
+            if (graph.n <= parameters.leaf_size) solve_leaf(graph);
+            else {
+                node_t const t = parameters.target(graph.n);
+                if (node_t const s = parameters.shared_target(graph.n); s < graph.n) graph = contract(graph, s);
+                for (std::size_t i = 0; i < parameters.nb_children; ++i) graphs.push(contract(graph, t));
+            }
+        }
+    } else {
+        /* Recomputing mode: the recursion goes depth first along a path of nodes, each storing the
+        seed its graph is contracted from its parent's with and the number of its children already
+        explored. Only the graphs of the nodes whose depth is a multiple of the interval are kept,
+        along with the one of the deepest node. The others are contracted again from their closest
+        kept ancestor when needed, which gives the same graphs since a contraction only depends on
+        its seed and on its parent: it shuffles indices of the parent's edges, always starting from
+        the identity. A node keeps its graph after the contraction shared by its children. */
+        auto contract_copy = [](ContractedGraph const& graph, node_t nb_vertices, auto& mt) {
+            UnionFind uf{graph.uf};
+            auto const left = contract_indices(graph.edges, uf, nb_vertices, mt);
+            decltype(graph.edges) edges;
+            edges.reserve(std::size(left));
+            for (auto i : left)
+                if (auto const e = graph.edges[i]; !uf.connected(e.tail, e.head)) edges.push_back(e);
+            return ContractedGraph{nb_vertices, std::move(edges), std::move(uf)};
+        };
+        auto branch = [&](ContractedGraph graph, auto& mt) { // the contraction shared by the children
+            if (node_t const s = parameters.shared_target(graph.n); graph.n > parameters.leaf_size && s < graph.n)
+                return contract_copy(graph, s, mt);
+            return graph;
+        };
+
+        struct Node { std::uint64_t seed; node_t nb_vertices; std::size_t nb_children_done; std::optional<ContractedGraph> graph; };
+        auto const interval = parameters.recompute_interval;
+        auto child_graph = [&](Node const& parent, std::uint64_t seed) {
+            SplitMix64 mt{seed};
+            return branch(contract_copy(*parent.graph, parameters.target(parent.nb_vertices), mt), mt);
+        };
+        auto materialize = [&](std::vector<Node>& path) {
+            auto i = std::size(path) - 1;
+            while (!path[i].graph) --i; // the root is always kept
+            for (++i; i < std::size(path); ++i) {
+                path[i].graph = child_graph(path[i - 1], path[i].seed);
+                if ((i - 1) % interval) path[i - 1].graph.reset();
+            }
+        };
+
+        std::vector<Node> path;
+        ContractedGraph root{input_graph.n, input_graph.edges, {input_graph.n}};
+        auto& mt = prng_engine();
+        if (root.n <= parameters.leaf_size) solve_leaf(root);
+        else path.push_back({0, input_graph.n, 0, branch(std::move(root), mt)});
+        while (!path.empty() && bound() > lower_bound) // algorithm's main loop
+        {
+            if (path.back().nb_children_done == parameters.nb_children) { path.pop_back(); continue; }
+            if (!path.back().graph) materialize(path);
+            ++path.back().nb_children_done;
+            auto const seed = std::uint64_t{mt()} << 32 | mt();
+            auto child = child_graph(path.back(), seed);
+            if (child.n <= parameters.leaf_size) { solve_leaf(child); continue; }
+            if ((std::size(path) - 1) % interval) path.back().graph.reset();
+            path.push_back({seed, static_cast<node_t>(parameters.target(path.back().nb_vertices)), 0, std::move(child)});
         }
     }
 
+    if (with_cut_edges && std::size(best_minimum_cut.cut_edges) != best_minimum_cut.cut_size
+        && best_minimum_cut.cut_size != std::numeric_limits<std::size_t>::max()) // the minimum degree cut
+        for (auto e : input_graph.edges)
+            if (!best_minimum_cut.uf.connected(e.tail, e.head)) best_minimum_cut.cut_edges.push_back(e);
     return best_minimum_cut;
 }
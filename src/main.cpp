@@ -3,9 +3,30 @@
 #include <functional>
 #include <array>
 #include <chrono>
+#include <filesystem>
+#include <optional>
+#include <random>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <vector>
 
 #include "karger.hpp"
+#include "dense_karger.hpp"
+#include "parallel_karger.hpp"
+#include "parallel.hpp"
+#include "numa.hpp"
+#include "multiprocess.hpp"
+#include "checkpoint.hpp"
+#include "skeleton.hpp"
+#include "generators.hpp"
+#include "check.hpp"
+#include "partitioning.hpp"
 #include "instance_reader.hpp"
+#include "report.hpp"
+#include "batch.hpp"
+#include "normalization.hpp"
+#include "autotune.hpp"
 
 
 void minimal_example()
@@ -28,41 +49,480 @@ void minimal_example()
 }
 
 
-int main(int argc, char* argv[])
+/* Parses the options and runs the requested mode, returning the exit status. */
+int run(int argc, char* argv[])
 {
     using node_t = std::uint32_t;
-    if (argc != 2) throw std::runtime_error("No input file.");
-    auto graph = read_col_instance<node_t>(argv[1]);
+    std::vector<char const*> files;
+    std::size_t nb_threads = std::max(1u, std::thread::hardware_concurrency());
+    std::size_t nb_processes = 1;
+    std::uint64_t seed = std::random_device{}();
+    char const* checkpoint_file = nullptr;
+    std::chrono::seconds checkpoint_interval{60};
+    bool resume = false;
+    std::optional<double> epsilon;
+    char const* generator = nullptr;
+    char const* output_file = nullptr;
+    bool check = false;
+    double check_budget = 1e7;
+    std::optional<std::size_t> partition_depth;
+    std::size_t min_cluster_size = 2;
+    bool balanced = false;
+    bool print_cut_edges = false;
+    OutputFormat format = OutputFormat::text;
+    bool print_sides = false;
+    std::optional<std::string_view> normalization_mode;
+    bool trusted = false;
+    std::optional<double> tuning_target;
+    std::size_t recompute_interval = 0;
+    bool intra_trial = false;
+    bool mst = false;
+    for (int i = 1; i < argc; ++i) {
+        std::string_view const arg{argv[i]};
+        if (arg == "--threads" && i + 1 < argc) {
+            nb_threads = std::stoul(argv[++i]);
+            if (nb_threads < 1) throw std::runtime_error("At least one thread is needed.");
+        }
+        else if (arg == "--processes" && i + 1 < argc) nb_processes = std::stoul(argv[++i]);
+        else if (arg == "--seed" && i + 1 < argc) seed = std::stoull(argv[++i]);
+        else if (arg == "--checkpoint" && i + 1 < argc) checkpoint_file = argv[++i];
+        else if (arg == "--checkpoint-interval" && i + 1 < argc) checkpoint_interval = std::chrono::seconds{std::stoul(argv[++i])};
+        else if (arg == "--resume") resume = true;
+        else if (arg == "--approximate" && i + 1 < argc) epsilon = std::stod(argv[++i]);
+        else if (arg == "--generate" && i + 1 < argc) generator = argv[++i];
+        else if (arg == "--write" && i + 1 < argc) output_file = argv[++i];
+        else if (arg == "--check") check = true;
+        else if (arg == "--check-budget" && i + 1 < argc) check_budget = std::stod(argv[++i]);
+        else if (arg == "--partition" && i + 1 < argc) partition_depth = std::stoul(argv[++i]);
+        else if (arg == "--min-cluster-size" && i + 1 < argc) min_cluster_size = std::stoul(argv[++i]);
+        else if (arg == "--balanced") balanced = true;
+        else if (arg == "--cut-edges") print_cut_edges = true;
+        else if (arg == "--format" && i + 1 < argc) format = parse_output_format(argv[++i]);
+        else if (arg == "--sides") print_sides = true;
+        else if (arg == "--trusted") trusted = true;
+        else if (arg == "--tune" && i + 1 < argc) tuning_target = std::stod(argv[++i]);
+        else if (arg == "--recompute" && i + 1 < argc) recompute_interval = std::stoul(argv[++i]);
+        else if (arg == "--intra-trial") intra_trial = true;
+        else if (arg == "--mst") intra_trial = mst = true;
+        else if (arg == "--normalize" && i + 1 < argc) {
+            normalization_mode = argv[++i];
+            if (normalization_mode != "loops" && normalization_mode != "simple")
+                throw std::runtime_error("Unknown normalization \"" + std::string{*normalization_mode} + "\".");
+        }
+        else files.push_back(argv[i]);
+    }
+    if (format != OutputFormat::text && (check || partition_depth || output_file))
+        throw std::runtime_error("--format only applies to runs of the algorithms, not to --check, --partition or --write.");
+
+    /* Checks the engines on the given instances and on generated graphs with a planted minimum
+    cut, and fails if any check does. */
+    if (check) {
+        std::size_t nb_failures = check_async();
+        for (auto instance : files) nb_failures += check_engines(instance, read_instance<node_t>(instance), std::nullopt, seed, check_budget);
+        for (auto spec : {"planted:30,3,5", "planted:120,4,7", "regular:40,6", "grid:5,6", "grid:1,12"}) {
+            seed_trial(seed, std::numeric_limits<std::uint64_t>::max() - 1);
+            auto generated = generate<node_t>(spec, prng_engine());
+            nb_failures += check_engines(spec, generated.graph, generated.min_cut, seed, check_budget);
+        }
+        std::cout << (nb_failures ? "\nFAILED: " + std::to_string(nb_failures) + " check(s), seed " + std::to_string(seed)
+                                  : std::string{"\nAll checks passed."}) << '\n';
+        return nb_failures ? 1 : 0;
+    }
+
+    /* Repetitions of each algorithm for a graph with n vertices, for a high probability of success. */
+    auto const karger_repetitions = [](double n) { return 0.5 * n * (n - 1) * std::log(n); };
+    auto const karger_stein_repetitions = [](double n) { return std::log(n) * std::log(n); };
+
+    /* Batch mode, for several instance files or a directory of them: the instances are loaded in the
+    background and solved two at a time on a shared pool, with a record per instance and algorithm.
+    Each instance gets the trials it would get alone, seeded from their index. */
+    if (!generator && (std::size(files) > 1 || (std::size(files) == 1 && std::filesystem::is_directory(files[0])))) {
+        if (checkpoint_file || resume || nb_processes > 1 || epsilon || partition_depth || output_file || tuning_target
+            || intra_trial || print_cut_edges)
+            throw std::runtime_error("Batch runs don't support checkpoints, worker processes, approximation, partitioning, tuning, "
+                                     "intra-trial parallelism, cut edges or writing.");
+        ThreadPool pool{nb_threads};
+        RecordWriter writer{std::cout, format};
+        KargerSteinParameters karger_stein_parameters;
+        karger_stein_parameters.recompute_interval = recompute_interval;
+        std::atomic<std::size_t> nb_skipped{0}; // the instances which couldn't be read make the batch fail
+        run_batch<node_t>(batch_instances(files), [&](LoadedInstance<node_t>& instance) {
+            if (instance.error) {
+                try { std::rethrow_exception(instance.error); }
+                catch (std::exception const& error) { std::cerr << "Skipping \"" << instance.file << "\": " << error.what() << '\n'; }
+                ++nb_skipped;
+                return;
+            }
+            auto& graph = instance.graph;
+            auto const setup_start{std::chrono::steady_clock::now()};
+            RunRecord record{instance.file, graph.n, 0, {}, 0, std::nullopt, std::nullopt,
+                             instance.load_ms, 0, 0, seed, nb_threads, 1, std::nullopt};
+            if (normalization_mode) {
+                auto const report = normalize(graph, normalization_mode == "simple", &pool);
+                record.removed_self_loops = report.nb_self_loops;
+                record.removed_duplicates = report.nb_duplicates;
+            }
+            record.m = std::size(graph.edges);
+            if (graph.n < 2 || !is_connected(graph)) {
+                if (graph.n >= 2) record.cut_size = 0;
+                record.engine = "connectivity";
+                writer.write(record);
+                return;
+            }
+            std::optional<DenseGraph<node_t>> dense_graph;
+            if (!recompute_interval && is_dense(graph)) dense_graph.emplace(graph);
+            record.setup_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - setup_start).count();
+
+            for (bool const stein : {false, true}) {
+                record.engine = !stein ? "Karger" : dense_graph ? "Karger-Stein (dense)" : "Karger-Stein";
+                record.nb_trials = !stein ? static_cast<std::size_t>(karger_repetitions(graph.n))
+                                          : std::max<std::size_t>(1, karger_stein_repetitions(graph.n));
+                Incumbent<node_t> incumbent;
+                auto const start{std::chrono::steady_clock::now()};
+                parallel_for(pool, record.nb_trials, [&](std::size_t i, std::size_t) {
+                    seed_trial(seed, i);
+                    if (!stein) incumbent.offer(karger_union_find(std::as_const(graph)));
+                    else if (dense_graph) incumbent.offer(karger_stein_dense(*dense_graph, &incumbent.cut_size));
+                    else incumbent.offer(karger_stein_union_find(graph, &incumbent.cut_size, false, karger_stein_parameters));
+                });
+                record.solve_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+                record.cut_size = incumbent.cut ? std::optional{incumbent.cut->cut_size} : std::nullopt;
+                record.sides.reset();
+                if (print_sides && incumbent.cut) {
+                    record.sides.emplace();
+                    for (auto side : incumbent.cut->get_sides()) record.sides->push_back('0' + side);
+                }
+                writer.write(record);
+            }
+        }, trusted);
+        if (nb_skipped) std::cerr << nb_skipped << " instance(s) skipped.\n";
+        return nb_skipped ? 1 : 0;
+    }
+
+    char const* file = generator ? generator : files.empty() ? nullptr : files.back();
+    if (!file) throw std::runtime_error("No input file.");
+    if (resume && !checkpoint_file) throw std::runtime_error("No checkpoint to resume from.");
+    if (checkpoint_file && nb_processes > 1) throw std::runtime_error("Checkpoints need a single process.");
+    if (checkpoint_file && tuning_target) throw std::runtime_error("Tuned runs can't be checkpointed."); // timing-dependent
+
+    /* A resumed campaign goes on with the seed of the checkpoint, which also tells how far it went
+    (and gives back the same generated graph). */
+    std::optional<Checkpoint> resumed;
+    if (resume && std::filesystem::exists(checkpoint_file)) {
+        resumed = Checkpoint::load(checkpoint_file);
+        seed = resumed->seed;
+    }
+
+    /* A generated graph is drawn from the seed, so that a run on it is reproducible too. */
+    std::optional<std::size_t> known_min_cut;
+    EdgesVectorGraph<node_t> graph;
+    auto const load_start{std::chrono::steady_clock::now()};
+    if (generator) {
+        seed_trial(seed, std::numeric_limits<std::uint64_t>::max() - 1);
+        auto generated = generate<node_t>(generator, prng_engine());
+        graph = std::move(generated.graph);
+        known_min_cut = generated.min_cut;
+    } else {
+        graph = read_instance<node_t>(file, trusted);
+    }
+    auto const milliseconds_since = [](auto start) {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    };
+
+    /* The normalization of the graph counts as part of its loading. */
+    std::optional<NormalizationReport> normalization;
+    if (normalization_mode) {
+        ThreadPool pool{nb_threads};
+        normalization = normalize(graph, normalization_mode == "simple", &pool);
+        if (normalization->nb_duplicates) known_min_cut.reset(); // counted the parallel edges
+    }
+    auto const load_ms = milliseconds_since(load_start);
+    if (output_file) {
+        write_binary_instance(graph, output_file);
+        std::cout << "Graph \"" << file << "\" (|V| = " << graph.n << ", |E| = " << std::size(graph.edges)
+                  << ") written to \"" << output_file << "\"\n";
+        return 0;
+    }
+
+    /* Recursive bisection: prints the tree of clusters, each leaf with its vertices (numbered from 1
+    as in the instance files). */
+    if (partition_depth) {
+        std::cout << "\nInput graph: \"" << file << "\" (|V| = " << graph.n << ", |E| = " << std::size(graph.edges)
+                  << ")\nThreads: " << nb_threads << ", seed: " << seed << "\n\n";
+        ThreadPool pool{nb_threads};
+        auto const time_start{std::chrono::steady_clock::now()};
+        auto const tree = recursive_bisection(std::move(graph), pool, seed, *partition_depth, min_cluster_size, balanced);
+        auto const duration = duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - time_start).count();
+        auto print = [&](auto& print, std::size_t c) -> void {
+            auto const& cluster = tree.clusters[c];
+            std::cout << std::string(2 * cluster.depth, ' ') << "- " << cluster.nb_vertices << " vertices";
+            if (cluster.is_leaf()) {
+                std::cout << ": {";
+                for (std::size_t i = 0; i < cluster.nb_vertices; ++i) std::cout << ' ' << tree.vertices[cluster.first_vertex + i] + 1;
+                std::cout << " }\n";
+                return;
+            }
+            std::cout << ", cut " << cluster.cut_size << '\n';
+            for (auto child : cluster.children) print(print, child);
+        };
+        print(print, 0);
+        std::cout << "\nClusters: " << std::size(tree.clusters) << ", duration: " << duration << "ms\n\n";
+        return 0;
+    }
+
+    auto const setup_start{std::chrono::steady_clock::now()};
+    Checkpoint checkpoint{file, graph.n, seed, {}, 0, 0, std::nullopt, {}};
+    if (resumed) {
+        if (resumed->instance != file || resumed->n != graph.n)
+            throw std::runtime_error("The checkpoint belongs to another instance.");
+        checkpoint = std::move(*resumed);
+    }
 
-    std::cout << "\nInput graph: \"" << argv[1] << "\" (|V| = " << graph.n << ", |E| = "
+    /* In the machine-readable formats, the human-readable text is discarded and a record is
+    written per algorithm instead. */
+    std::ostream null_stream{nullptr};
+    std::ostream& text = format == OutputFormat::text ? std::cout : null_stream;
+    std::optional<RecordWriter> writer;
+    if (format != OutputFormat::text) writer.emplace(std::cout, format);
+    RunRecord record{file, graph.n, std::size(graph.edges), {}, 0, std::nullopt, known_min_cut, load_ms, 0, 0,
+                     seed, nb_threads, nb_processes, std::nullopt};
+    if (normalization) {
+        record.removed_self_loops = normalization->nb_self_loops;
+        record.removed_duplicates = normalization->nb_duplicates;
+    }
+
+    text << "\nInput graph: \"" << file << "\" (|V| = " << graph.n << ", |E| = "
         << std::size(graph.edges) << ")\n";
+    if (normalization)
+        text << "Normalization: " << normalization->nb_self_loops << " self-loop(s) and " << normalization->nb_duplicates
+             << " duplicate edge(s) removed\n";
+    if (known_min_cut) text << "Known minimum cut's size: " << *known_min_cut << '\n';
+    if (graph.n < 2 || !is_connected(graph)) { // the algorithms expect a connected graph
+        if (graph.n < 2) text << "The graph has no cut.\n\n";
+        else { text << "The graph isn't connected: its minimum cut's size is 0.\n\n"; record.cut_size = 0; }
+        record.engine = "connectivity";
+        if (writer) writer->write(record);
+        return 0;
+    }
+
+    /* In approximate mode, the algorithms run on a skeleton of the graph, with fewer repetitions
+    since any cut within a factor 1 + ε of the minimum will do, and the best cut is then measured on
+    the whole graph. The skeleton only depends on the seed, so that checkpoints remain valid. */
+    std::optional<EdgesVectorGraph<node_t>> full_graph;
+    double repetitions_factor = 1;
+    if (epsilon) {
+        seed_trial(seed, std::numeric_limits<std::uint64_t>::max());
+        auto& mt = prng_engine();
+        auto sampled = approximate_skeleton(graph, *epsilon, mt);
+        full_graph = std::exchange(graph, std::move(sampled.graph));
+        repetitions_factor = 1 / ((1 + *epsilon) * (1 + *epsilon));
+        text << "Skeleton: p = " << sampled.p << " (|E| = " << std::size(graph.edges) << "), epsilon = " << *epsilon << '\n';
+    }
 
     struct MinimumCutAlgorithm {
         std::string name;
-        std::function<GraphCut<node_t>(EdgesVectorGraph<node_t>&)> algorithm;
+        std::function<GraphCut<node_t>(EdgesVectorGraph<node_t> const&, std::atomic<std::size_t> const&)> algorithm;
         std::size_t nb_repeat;
-        auto operator()(EdgesVectorGraph<node_t>& graph) const { return algorithm(graph); }
+        bool intra_trial = false; // trials one at a time, each on the whole pool (Karger's algorithm only)
+        auto operator()(EdgesVectorGraph<node_t> const& graph, std::atomic<std::size_t> const& incumbent) const {
+            return algorithm(graph, incumbent);
+        }
+    };
+
+    /* With tuning, Karger-Stein runs with the parameters found fastest for the target probability of
+    success on the edge-list engine, which is the one tuned (and the one recomputing its graphs). */
+    std::optional<TunedKargerStein> tuned;
+    if (tuning_target) {
+        seed_trial(seed, std::numeric_limits<std::uint64_t>::max() - 2);
+        tuned = autotune_karger_stein(graph, *tuning_target);
+        auto const& parameters = tuned->parameters;
+        text << "Tuned Karger-Stein: " << parameters.nb_children << " children, contraction ratio " << parameters.contraction_ratio
+             << ", leaves of at most " << parameters.leaf_size << " vertices solved "
+             << (parameters.leaf_solver == LeafSolver::exact ? "exactly" : "by contraction") << " (" << tuned->nb_runs
+             << " runs of " << tuned->run_ms << "ms for a success probability of " << *tuning_target << ")\n";
+    }
+
+    std::optional<DenseGraph<node_t>> dense_graph; // Karger-Stein runs on the dense engine if worth it
+    if (!tuned && !recompute_interval && is_dense(graph)) dense_graph.emplace(graph);
+    auto karger_stein_parameters = tuned ? tuned->parameters : KargerSteinParameters{};
+    karger_stein_parameters.recompute_interval = recompute_interval;
+    auto const nodes = numa_nodes();
+    auto const node_of = numa_assignment(nodes, nb_threads);
+    std::optional<NumaReplicas<DenseGraph<node_t>>> dense_replicas; // made lazily by the workers
+    if (dense_graph) dense_replicas.emplace(*dense_graph, std::size(nodes));
+
+    /* Workers are pinned to the NUMA nodes. The engines only read the graph (Karger's algorithm
+    shuffles indices of its edges), which is replicated once per node so that its pages are allocated
+    on the local memory of the workers, as is the dense graph. */
+    NumaReplicas<EdgesVectorGraph<node_t>> replicas{graph, std::size(nodes)};
+    auto start_worker = [&](std::size_t worker) {
+        pin_current_thread(nodes[node_of[worker]]);
+        replicas.local(node_of[worker]);
+    };
+
+    /* Runs the trials [first, last) of the algorithm on the pool. Each trial is seeded from its
+    index, hence reproducible. */
+    auto run_trials = [&](ThreadPool& pool, MinimumCutAlgorithm const& algorithm, std::size_t first, std::size_t last,
+                          Incumbent<node_t>& incumbent, std::atomic<std::size_t> const* shared_incumbent,
+                          std::function<void()> const& on_trial = {}) {
+        if (algorithm.intra_trial) {
+            for (auto i = first; i < last; ++i) {
+                if (shared_incumbent) incumbent.tighten(shared_incumbent->load(std::memory_order_relaxed));
+                seed_trial(seed, i);
+                incumbent.offer(mst ? parallel_karger_mst(graph, pool, print_cut_edges)
+                                    : parallel_karger_union_find(graph, pool, print_cut_edges));
+                if (on_trial) on_trial();
+            }
+            return;
+        }
+        parallel_for(pool, last - first, [&](std::size_t i, std::size_t worker) {
+            if (shared_incumbent) incumbent.tighten(shared_incumbent->load(std::memory_order_relaxed));
+            seed_trial(seed, first + i);
+            incumbent.offer(algorithm(replicas.local(node_of[worker]), incumbent.cut_size));
+            if (on_trial) on_trial();
+        });
+    };
+
+    auto karger = [&](EdgesVectorGraph<node_t> const& graph, auto const&) { return karger_union_find(graph, print_cut_edges); };
+    auto karger_stein = [&](EdgesVectorGraph<node_t> const& graph, std::atomic<std::size_t> const& incumbent) {
+        if (!dense_replicas) return karger_stein_union_find(graph, &incumbent, print_cut_edges, karger_stein_parameters);
+        return karger_stein_dense(dense_replicas->local(node_of[ThreadPool::worker_index()]), &incumbent);
     };
 
     std::array<MinimumCutAlgorithm, 2> algorithms{{
-        {"Karger",       karger_union_find<node_t>,       static_cast<std::size_t>(0.5 * graph.n * (graph.n - 1) * std::log(graph.n))},
-        {"Karger-Stein", karger_stein_union_find<node_t>, static_cast<std::size_t>(std::log(graph.n) * std::log(graph.n))}
-    }}; 
+        {mst ? "Karger (MST)" : intra_trial ? "Karger (intra-trial)" : "Karger", karger, static_cast<std::size_t>(repetitions_factor * karger_repetitions(graph.n)), intra_trial},
+        {dense_graph ? "Karger-Stein (dense)" : tuned ? "Karger-Stein (tuned)" : "Karger-Stein", karger_stein,
+            std::max<std::size_t>(1, repetitions_factor * (tuned ? tuned->nb_runs : karger_stein_repetitions(graph.n)))}
+    }};
 
-    for (auto const& algorithm : algorithms)
+    text << "Threads: " << nb_threads << " (NUMA nodes: " << std::size(nodes) << "), processes: "
+              << nb_processes << ", seed: " << seed << '\n';
+
+    std::optional<ThreadPool> pool; // worker processes start their own pool after being forked
+    if (nb_processes == 1) pool.emplace(nb_threads, start_worker);
+    record.setup_ms = milliseconds_since(setup_start);
+
+    for (std::size_t a = 0; a < std::size(algorithms); ++a)
     {
-        std::cout << "\nAlgorithm: \"" << algorithm.name << "\"\n"
+        auto const& algorithm = algorithms[a];
+        text << "\nAlgorithm: \"" << algorithm.name << "\"\n"
                   << "    - Number of repetitions: " << algorithm.nb_repeat << '\n';
-        GraphCut<node_t> best_minimum_cut{graph.n, {{}}};
+        if (a < std::size(checkpoint.results)) { // already done before the checkpoint
+            auto const& result = checkpoint.results[a];
+            text << "    - Best minimum cut's size found: " << (result.cut_size ? std::to_string(*result.cut_size) : "none")
+                      << "\n    - Duration: " << result.duration_ms << "ms (resumed)\n";
+            if (writer) {
+                record.engine = algorithm.name; record.nb_trials = algorithm.nb_repeat;
+                record.cut_size = result.cut_size; record.solve_ms = result.duration_ms; record.sides.reset();
+                writer->write(record);
+            }
+            continue;
+        }
+        std::optional<GraphCut<node_t>> best_minimum_cut;
+        auto nb_trials_done = algorithm.nb_repeat;
         auto time_start{std::chrono::steady_clock::now()};
+        auto elapsed_ms = [&] { return checkpoint.elapsed_ms + milliseconds_since(time_start); }; // fractional, as in the records
 
-        for(std::size_t i = algorithm.nb_repeat; i; --i)
-            best_minimum_cut = std::min(best_minimum_cut, algorithm(graph));
+        if (nb_processes > 1) {
+#ifdef KARGER_HAS_FORK
+            /* Each worker process runs a range of trials with its own pool, publishing its best cut
+            and counting its finished trials in shared memory where the coordinator merges them, even
+            if some workers crashed. */
+            SharedResults<node_t> results{graph.n, nb_processes};
+            auto const nb_failures = run_sharded(algorithm.nb_repeat, nb_processes,
+                [&](std::size_t first, std::size_t last, std::size_t worker) {
+                    ThreadPool pool{nb_threads, start_worker};
+                    Incumbent<node_t> incumbent;
+                    incumbent.on_improvement = [&](auto const& cut) { results.publish(worker, cut); };
+                    run_trials(pool, algorithm, first, last, incumbent, &results.incumbent(),
+                               [&] { results.count_trial(worker); });
+                });
+            best_minimum_cut = results.best();
+            nb_trials_done = results.nb_trials();
+            if (nb_failures) text << "    - Failed worker processes: " << nb_failures << " (" << nb_trials_done << " of "
+                                  << algorithm.nb_repeat << " trials finished)\n";
+#else
+            throw std::runtime_error("Worker processes aren't supported on this platform.");
+#endif
+        } else {
+            /* With checkpoints, trials run by batches, after which the checkpoint is saved if its
+            interval has elapsed. Batches are large enough for their synchronization to be cheap. */
+            Incumbent<node_t> incumbent;
+            if (checkpoint.cut_size)
+                incumbent.offer(cut_from_sides(*checkpoint.cut_size, checkpoint.sides.data(), graph.n));
+            auto const nb_workers = std::max<std::size_t>(1, pool->size());
+            auto const batch = checkpoint_file
+                ? nb_workers * std::max<std::size_t>(1, algorithm.nb_repeat / (nb_workers * 1024)) : algorithm.nb_repeat;
+            auto last_save = std::chrono::steady_clock::now();
+            for (auto first = checkpoint.nb_trials_done; first < algorithm.nb_repeat;) {
+                auto const last = std::min(algorithm.nb_repeat, first + batch);
+                run_trials(*pool, algorithm, first, last, incumbent, nullptr);
+                first = last;
+                if (checkpoint_file && std::chrono::steady_clock::now() - last_save >= checkpoint_interval) {
+                    auto current = checkpoint;
+                    current.nb_trials_done = first;
+                    current.elapsed_ms = static_cast<std::uint64_t>(elapsed_ms());
+                    current.cut_size.reset(); current.sides.clear();
+                    if (incumbent.cut) { current.cut_size = incumbent.cut->cut_size; current.sides = incumbent.cut->get_sides(); }
+                    current.save(checkpoint_file);
+                    last_save = std::chrono::steady_clock::now();
+                }
+            }
+            best_minimum_cut = std::move(incumbent.cut);
+        }
         
-        auto duration = duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - time_start).count();
-        std::cout << "    - Best minimum cut's size found: " << best_minimum_cut.cut_size
-                  << "\n    - Duration: " << duration << "ms\n";
+        std::optional<std::size_t> skeleton_cut_size;
+        if (full_graph && best_minimum_cut) {
+            skeleton_cut_size = best_minimum_cut->cut_size;
+            best_minimum_cut->cut_size = crossing_edges_count(*full_graph, *best_minimum_cut);
+            best_minimum_cut->cut_edges.clear();
+            best_minimum_cut = std::min(*best_minimum_cut, minimum_degree_cut(*full_graph));
+        }
+
+        auto const duration = elapsed_ms();
+        text << "    - Best minimum cut's size found: ";
+        if (best_minimum_cut) text << best_minimum_cut->cut_size; else text << "none";
+        if (skeleton_cut_size) text << " (" << *skeleton_cut_size << " in the skeleton)";
+        text << "\n    - Duration: " << static_cast<std::uint64_t>(duration) << "ms\n";
+        if (print_cut_edges && best_minimum_cut) { // the dense engine and worker processes don't keep the edges
+            if (std::size(best_minimum_cut->cut_edges) != best_minimum_cut->cut_size)
+                best_minimum_cut->cut_edges = crossing_edges(full_graph ? *full_graph : graph, *best_minimum_cut);
+            text << "    - Cut edges:";
+            for (auto e : best_minimum_cut->cut_edges) text << " {" << e.tail + 1 << ", " << e.head + 1 << '}';
+            text << '\n';
+        }
+        record.sides.reset();
+        if (print_sides && best_minimum_cut) {
+            record.sides.emplace();
+            for (auto side : best_minimum_cut->get_sides()) record.sides->push_back('0' + side);
+            text << "    - Sides: " << *record.sides << '\n';
+        }
+        if (writer) {
+            record.engine = algorithm.name; record.nb_trials = nb_trials_done;
+            record.cut_size = best_minimum_cut ? std::optional{best_minimum_cut->cut_size} : std::nullopt;
+            record.solve_ms = duration;
+            writer->write(record);
+        }
+
+        checkpoint.results.push_back({best_minimum_cut ? std::optional{best_minimum_cut->cut_size} : std::nullopt,
+                                      static_cast<std::uint64_t>(duration)});
+        checkpoint.nb_trials_done = checkpoint.elapsed_ms = 0;
+        checkpoint.cut_size.reset(); checkpoint.sides.clear();
+        if (checkpoint_file) checkpoint.save(checkpoint_file);
     }
     
-    std::cout << "\n";
-}
\ No newline at end of file
+    text << "\n";
+    return 0;
+}
+
+
+/* Reports the errors, of the options or of the instances, instead of letting them abort. */
+int main(int argc, char* argv[])
+{
+    try {
+        return run(argc, argv);
+    } catch (std::exception const& error) {
+        std::cerr << "Error: " << error.what() << '\n';
+        return 1;
+    }
+}
@@ -0,0 +1,135 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstdint>
+#include <iostream>
+#include <limits>
+#include <new>
+#include <optional>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+#include "karger.hpp"
+#include "parallel.hpp"
+#if __has_include(<sys/mman.h>) && __has_include(<sys/wait.h>) && __has_include(<unistd.h>)
+#define KARGER_HAS_FORK 1
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+
+#ifdef KARGER_HAS_FORK
+/* Results of worker processes gathered in an anonymous shared memory mapping, which outlives the
+crash of any of them: the incumbent cut size, and for each worker its number of finished trials and
+its best cut as the side of each vertex. A worker writes its new cut into the buffer which isn't
+published before publishing it, so that a crash in the middle of a write leaves the previous cut
+intact. */
+template <typename node_t>
+class SharedResults
+{
+    struct Slot {
+        std::atomic<std::size_t> nb_trials{0};
+        std::atomic<unsigned> published{0}; // 1 + index of the buffer holding the cut, 0 if none
+        std::size_t cut_sizes[2];
+    };
+    static_assert(std::atomic<std::size_t>::is_always_lock_free && std::atomic<unsigned>::is_always_lock_free,
+        "atomics shared between processes must be lock-free");
+
+public:
+    SharedResults(node_t n, std::size_t nb_workers) : n{n}, nb_workers{nb_workers},
+        bytes{sizeof(std::atomic<std::size_t>) + nb_workers * (sizeof(Slot) + 2 * n)} {
+        memory = static_cast<std::byte*>(mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0));
+        if (memory == MAP_FAILED) throw std::runtime_error("Cannot map the shared results.");
+        new (memory) std::atomic<std::size_t>{std::numeric_limits<std::size_t>::max()};
+        for (std::size_t worker = 0; worker < nb_workers; ++worker) new (&slot(worker)) Slot;
+    }
+
+    SharedResults(SharedResults const&) = delete;
+    ~SharedResults() { munmap(memory, bytes); }
+
+    std::atomic<std::size_t>& incumbent() { return *std::launder(reinterpret_cast<std::atomic<std::size_t>*>(memory)); }
+
+    void count_trial(std::size_t worker) { slot(worker).nb_trials.fetch_add(1, std::memory_order_relaxed); }
+
+    void publish(std::size_t worker, GraphCut<node_t> const& cut) {
+        auto& s = slot(worker);
+        unsigned const buffer = s.published.load(std::memory_order_relaxed) == 1; // the other one
+        std::ranges::copy(cut.get_sides(), sides(worker, buffer));
+        s.cut_sizes[buffer] = cut.cut_size;
+        s.published.store(buffer + 1, std::memory_order_release);
+        atomic_fetch_min(incumbent(), cut.cut_size);
+    }
+
+    /* The best cut published by the workers, if any. */
+    std::optional<GraphCut<node_t>> best() {
+        std::optional<GraphCut<node_t>> best_cut;
+        for (std::size_t worker = 0; worker < nb_workers; ++worker) {
+            auto& s = slot(worker);
+            if (auto const published = s.published.load(std::memory_order_acquire))
+                if (!best_cut || s.cut_sizes[published - 1] < best_cut->cut_size)
+                    best_cut = cut_from_sides(s.cut_sizes[published - 1], sides(worker, published - 1), n);
+        }
+        return best_cut;
+    }
+
+    std::size_t nb_trials() {
+        std::size_t total = 0;
+        for (std::size_t worker = 0; worker < nb_workers; ++worker)
+            total += slot(worker).nb_trials.load(std::memory_order_relaxed);
+        return total;
+    }
+
+private:
+    Slot& slot(std::size_t worker) {
+        auto* const slots = memory + sizeof(std::atomic<std::size_t>);
+        return *std::launder(reinterpret_cast<Slot*>(slots + worker * sizeof(Slot)));
+    }
+
+    std::uint8_t* sides(std::size_t worker, unsigned buffer) {
+        auto* const all_sides = memory + sizeof(std::atomic<std::size_t>) + nb_workers * sizeof(Slot);
+        return reinterpret_cast<std::uint8_t*>(all_sides + (2 * worker + buffer) * n);
+    }
+
+    node_t n;
+    std::size_t nb_workers;
+    std::size_t bytes;
+    std::byte* memory;
+};
+
+
+/* Runs the trials [0, nb_trials) in nb_processes forked worker processes, worker w running the
+trials [w * nb_trials / nb_processes, (w + 1) * nb_trials / nb_processes) by calling
+run(first, last, w). Each worker inherits the memory of the coordinator, so the input graph is
+shared copy-on-write and only the pages a worker writes to are duplicated. Must be called before
+any thread is started. Returns the number of workers which failed (non-zero exit or crash), or
+whose status couldn't be waited for. */
+template <typename Run>
+std::size_t run_sharded(std::size_t nb_trials, std::size_t nb_processes, Run&& run)
+{
+    std::cout.flush(); // otherwise, buffered output would be written by each worker too
+    std::vector<pid_t> workers;
+    for (std::size_t worker = 0; worker < nb_processes; ++worker) {
+        auto const pid = fork();
+        if (pid < 0) throw std::runtime_error("Cannot fork a worker process.");
+        if (pid == 0) {
+            int status = 0;
+            try { run(worker * nb_trials / nb_processes, (worker + 1) * nb_trials / nb_processes, worker); }
+            catch (std::exception const& e) { std::cerr << "Worker " << worker << ": " << e.what() << '\n'; status = 1; }
+            std::cout.flush();
+            _exit(status);
+        }
+        workers.push_back(pid);
+    }
+    std::size_t nb_failures = 0;
+    for (auto pid : workers) {
+        int status = 0;
+        auto result = waitpid(pid, &status, 0);
+        while (result < 0 && errno == EINTR) result = waitpid(pid, &status, 0);
+        nb_failures += result < 0 || !WIFEXITED(status) || WEXITSTATUS(status) != 0; // e.g. reaped already
+    }
+    return nb_failures;
+}
+#endif
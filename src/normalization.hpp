@@ -0,0 +1,50 @@
+#pragma once
+
+#include <algorithm>
+#include <span>
+#include <tuple>
+#include <vector>
+#include "karger.hpp"
+#include "parallel.hpp"
+#include "subgraphs.hpp"
+
+
+/* What normalize() removed from a graph. */
+struct NormalizationReport
+{
+    std::size_t nb_self_loops = 0;
+    std::size_t nb_duplicates = 0;
+};
+
+
+/* Removes the self-loops of the graph, which no cut crosses, and with dedupe, its repeated edges:
+each edge is stored with tail < head, then the edges are sorted and the copies of an edge (listed
+once in each direction, or several times) are dropped. The engines handle multigraphs, where
+parallel edges count in the cuts, so deduplicating is only meant for instances of simple graphs
+whose files repeat edges. With a pool, large graphs are normalized in parallel. Must not be called
+from a job of the pool. */
+template <typename node_t>
+NormalizationReport normalize(EdgesVectorGraph<node_t>& graph, bool dedupe = true, ThreadPool* pool = nullptr)
+{
+    NormalizationReport report;
+    auto const nb_kept = parallel_partition(std::span{graph.edges}, [](auto e) { return e.tail != e.head; }, pool);
+    report.nb_self_loops = std::size(graph.edges) - nb_kept;
+    graph.edges.resize(nb_kept);
+    if (!dedupe) return report;
+
+    auto canonicalize = [&](std::size_t first, std::size_t last) {
+        for (auto& e : std::span{graph.edges}.subspan(first, last - first))
+            if (e.tail > e.head) std::swap(e.tail, e.head);
+    };
+    if (pool && std::size(graph.edges) >= 1 << 16)
+        parallel_for(*pool, pool->size(), [&](std::size_t i, std::size_t) {
+            canonicalize(i * std::size(graph.edges) / pool->size(), (i + 1) * std::size(graph.edges) / pool->size());
+        });
+    else canonicalize(0, std::size(graph.edges));
+
+    parallel_sort(std::span{graph.edges}, pool, [](auto a, auto b) { return std::tie(a.tail, a.head) < std::tie(b.tail, b.head); });
+    auto const duplicates = std::ranges::unique(graph.edges, [](auto a, auto b) { return a.tail == b.tail && a.head == b.head; });
+    report.nb_duplicates = std::size(duplicates);
+    graph.edges.erase(begin(duplicates), end(duplicates));
+    return report;
+}
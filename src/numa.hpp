@@ -0,0 +1,94 @@
+#pragma once
+
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <vector>
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+
+/* Returns the CPUs of each NUMA node, as listed in /sys/devices/system/node/node<i>/cpulist (e.g.
+"0-15,32-47"). Machines without this information are seen as a single node with an empty list of
+CPUs, whose threads are then left unpinned. */
+inline std::vector<std::vector<int>> numa_nodes()
+{
+    std::vector<std::vector<int>> nodes;
+    for (int i = 0;; ++i) {
+        std::ifstream cpulist{"/sys/devices/system/node/node" + std::to_string(i) + "/cpulist"};
+        if (!cpulist) break;
+        auto& cpus = nodes.emplace_back();
+        for (std::string range; std::getline(cpulist, range, ',');) {
+            if (range.find_first_of("0123456789") == std::string::npos) continue;
+            auto const dash = range.find('-');
+            int const first = std::stoi(range);
+            int const last = dash == std::string::npos ? first : std::stoi(range.substr(dash + 1));
+            for (int cpu = first; cpu <= last; ++cpu) cpus.push_back(cpu);
+        }
+    }
+    if (nodes.empty()) nodes.emplace_back();
+    return nodes;
+}
+
+
+/* Restricts the calling thread to the given CPUs. Does nothing if the list is empty or if the
+platform doesn't support it. */
+inline void pin_current_thread(std::vector<int> const& cpus)
+{
+#ifdef __linux__
+    if (cpus.empty()) return;
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for (auto cpu : cpus) CPU_SET(cpu, &set);
+    pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+#else
+    (void) cpus;
+#endif
+}
+
+
+/* Assigns the worker threads to NUMA nodes by contiguous blocks, so that each node gets a share of
+the workers proportional to its number of CPUs (evenly if unknown). */
+inline std::vector<std::size_t> numa_assignment(std::vector<std::vector<int>> const& nodes, std::size_t nb_workers)
+{
+    std::size_t nb_cpus = 0;
+    for (auto const& cpus : nodes) nb_cpus += std::size(cpus);
+    std::vector<std::size_t> assignment;
+    assignment.reserve(nb_workers);
+    for (std::size_t worker = 0, node = 0, cumulated = 0; worker < nb_workers; ++worker) {
+        auto const share = [&](std::size_t i) { return nb_cpus ? std::size(nodes[i]) : 1; };
+        auto const total = nb_cpus ? nb_cpus : std::size(nodes);
+        while (node + 1 < std::size(nodes) && worker * total >= (cumulated + share(node)) * nb_workers)
+            cumulated += share(node++);
+        assignment.push_back(node);
+    }
+    return assignment;
+}
+
+
+/* One copy of a read-only object per NUMA node. Each copy is made by the first thread of the node
+asking for it so that, with the first-touch policy of the kernel, its pages are allocated on the
+node's local memory. With a single node, the object itself is used. */
+template <typename T>
+class NumaReplicas
+{
+public:
+    NumaReplicas(T const& source, std::size_t nb_nodes)
+        : source{source}, flags{std::make_unique<std::once_flag[]>(nb_nodes)}, replicas(nb_nodes) {}
+
+    T const& local(std::size_t node) {
+        if (std::size(replicas) == 1) return source;
+        std::call_once(flags[node], [&] { replicas[node].emplace(source); });
+        return *replicas[node];
+    }
+
+private:
+    T const& source;
+    std::unique_ptr<std::once_flag[]> flags;
+    std::vector<std::optional<T>> replicas;
+};
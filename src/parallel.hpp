@@ -0,0 +1,140 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <future>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <queue>
+#include <thread>
+#include <vector>
+#include "karger.hpp"
+
+
+/* A fixed set of worker threads executing the submitted jobs in FIFO order. Each worker first calls
+on_start with its index in [0, size()), e.g. to pin itself to some CPUs or to allocate its data. */
+class ThreadPool
+{
+public:
+    explicit ThreadPool(std::size_t nb_threads = std::max(1u, std::thread::hardware_concurrency()),
+        std::function<void(std::size_t)> on_start = {}) {
+        workers.reserve(nb_threads);
+        for (std::size_t i = 0; i < nb_threads; ++i)
+            workers.emplace_back([this, i, on_start] {
+                worker_index() = i;
+                if (on_start) on_start(i);
+                work();
+            });
+    }
+
+    ~ThreadPool() {
+        { std::scoped_lock lock{mutex}; stopping = true; }
+        ready.notify_all();
+    }
+
+    std::size_t size() const { return std::size(workers); }
+
+    /* Index of the calling worker thread (0 for a thread outside any pool). */
+    static std::size_t& worker_index() {
+        thread_local static std::size_t index = 0;
+        return index;
+    }
+
+    template <typename F>
+    auto submit(F&& f) {
+        auto task = std::make_shared<std::packaged_task<std::invoke_result_t<F>()>>(std::forward<F>(f));
+        auto future = task->get_future();
+        { std::scoped_lock lock{mutex}; jobs.emplace([task] { (*task)(); }); }
+        ready.notify_one();
+        return future;
+    }
+
+private:
+    void work() {
+        for (;;) {
+            std::function<void()> job;
+            {
+                std::unique_lock lock{mutex};
+                ready.wait(lock, [this] { return stopping || !jobs.empty(); });
+                if (jobs.empty()) return;
+                job = std::move(jobs.front());
+                jobs.pop();
+            }
+            job();
+        }
+    }
+
+    std::mutex mutex;
+    std::condition_variable ready;
+    std::queue<std::function<void()>> jobs;
+    bool stopping = false;
+    std::vector<std::jthread> workers; // last member: joined before the others are destroyed
+};
+
+
+/* Calls f(i, worker) for each i in [0, n) on the threads of the pool, worker being the index in
+[0, pool.size()) of the thread running it, so that f can use per-worker data. Indices are handed out
+one at a time since iterations (e.g. Karger-Stein runs) have very uneven durations. Blocks until all
+the iterations are done and rethrows the first exception raised by f, once every job has finished
+(they use the locals of the call): the iterations not started yet are then skipped. Must not be
+called from a job of the same pool. */
+template <typename F>
+void parallel_for(ThreadPool& pool, std::size_t n, F&& f)
+{
+    std::atomic<std::size_t> next{0};
+    std::vector<std::future<void>> jobs;
+    for (std::size_t job = 0, nb_jobs = std::min(pool.size(), n); job < nb_jobs; ++job)
+        jobs.push_back(pool.submit([&] {
+            auto const worker = ThreadPool::worker_index();
+            try {
+                for (std::size_t i; (i = next.fetch_add(1, std::memory_order_relaxed)) < n;) f(i, worker);
+            } catch (...) {
+                next.store(n, std::memory_order_relaxed);
+                throw;
+            }
+        }));
+    std::exception_ptr failure;
+    for (auto& job : jobs) {
+        try { job.get(); }
+        catch (...) { if (!failure) failure = std::current_exception(); }
+    }
+    if (failure) std::rethrow_exception(failure);
+}
+
+
+/* Lowers the atomic to value if it is greater. */
+inline void atomic_fetch_min(std::atomic<std::size_t>& atomic, std::size_t value)
+{
+    for (auto current = atomic.load(std::memory_order_relaxed);
+         value < current && !atomic.compare_exchange_weak(current, value, std::memory_order_relaxed);) {}
+}
+
+
+/* The best cut found so far by concurrent runs. Its size is read without locking by the runs to
+prune their search, while the cut itself is replaced under a mutex. The size may also be lowered by
+a cut found elsewhere (e.g. by another process), which then isn't stored here. on_improvement is
+called under the mutex with each new best cut. */
+template <typename node_t>
+struct Incumbent
+{
+    std::atomic<std::size_t> cut_size{std::numeric_limits<std::size_t>::max()};
+    std::optional<GraphCut<node_t>> cut;
+    std::function<void(GraphCut<node_t> const&)> on_improvement;
+    std::mutex mutex;
+
+    void offer(GraphCut<node_t>&& candidate) {
+        if (candidate.cut_size >= cut_size.load(std::memory_order_relaxed)) return;
+        std::scoped_lock lock{mutex};
+        if (candidate.cut_size >= cut_size.load(std::memory_order_relaxed)) return;
+        cut_size.store(candidate.cut_size, std::memory_order_relaxed);
+        cut = std::move(candidate);
+        if (on_improvement) on_improvement(*cut);
+    }
+
+    void tighten(std::size_t bound) { atomic_fetch_min(cut_size, bound); }
+};
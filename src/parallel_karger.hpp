@@ -0,0 +1,230 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <limits>
+#include <numeric>
+#include <random>
+#include <span>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+#include "karger.hpp"
+#include "parallel.hpp"
+#include "subgraphs.hpp"
+
+
+/* Number of chunks of size elements for the threads of the pool: at least grain elements each (but
+a single chunk), and at most 4 per thread, for the threads to share out uneven chunks. */
+inline std::size_t parallel_chunk_count(ThreadPool const& pool, std::size_t size, std::size_t grain)
+{
+    return std::clamp<std::size_t>(size / std::max<std::size_t>(1, grain), 1, 4 * pool.size());
+}
+
+
+/* Calls f(chunk, first, last) on the threads of the pool for consecutive chunks of [first, last),
+as many as parallel_chunk_count() gives. Must not be called from a job of the pool. */
+template <typename F>
+void parallel_chunks(ThreadPool& pool, std::size_t first, std::size_t last, std::size_t grain, F&& f)
+{
+    auto const n = parallel_chunk_count(pool, last - first, grain);
+    parallel_for(pool, n, [&](std::size_t i, std::size_t) {
+        f(i, first + i * (last - first) / n, first + (i + 1) * (last - first) / n);
+    });
+}
+
+
+/* Karger's contraction algorithm for a single trial on a huge graph, spread over the threads of the
+pool. It finds the cut karger_union_find() would find on the edges in a uniformly random order, so
+that the distribution of the cuts is the same:
+- The 32-bit indices of the edges are shuffled into a buffer of the calling thread in parallel
+  [Sanders, Random Permutations on Distributed, External and Hierarchical Memory, 1998]: each chunk
+  of edges sends its indices to random buckets, then each bucket is shuffled on its own. The numbers
+  of chunks and buckets only depend on m and each of them draws from its own SplitMix64 engine,
+  seeded from the engine of the calling thread, so that the cut doesn't depend on the number of
+  threads.
+- The edges are contracted in this order with a ConcurrentUnionFind. Since contracting a prefix of
+  the order gives the same partition whatever the order of its edges, a block of k - 2 edges, when k
+  subsets are left, is contracted concurrently: these edges can't merge the vertices into less than
+  two subsets. Once k - 2 edges are too few to keep the threads busy, the edges of larger blocks
+  already inside a subset, which stay so, are filtered out in parallel, and the others are merged in
+  order by the calling thread until two subsets are left.
+- The edges after the last one contracted are counted (and kept, with with_cut_edges) in parallel.
+grain is the least number of edges given to a thread at each step. The graph is assumed to be
+connected. Must not be called from a job of the pool. */
+template <typename node_t>
+GraphCut<node_t> parallel_karger_union_find(EdgesVectorGraph<node_t> const& graph, ThreadPool& pool,
+    bool with_cut_edges = false, std::size_t grain = 1 << 14)
+{
+    constexpr std::size_t MAX_BUCKETS = 256;
+    grain = std::max<std::size_t>(1, grain);
+    if (std::size(graph.edges) > std::numeric_limits<std::uint32_t>::max())
+        throw std::length_error("Too many edges for 32-bit indices.");
+    auto const m = std::size(graph.edges);
+    auto nb_chunks = [&](std::size_t size) { return parallel_chunk_count(pool, size, grain); };
+    auto in_chunks = [&](std::size_t first, std::size_t last, auto&& f) { parallel_chunks(pool, first, last, grain, f); };
+
+    thread_local static std::vector<std::uint32_t> buffer;
+    auto& indices = buffer; // the one of the calling thread, for the jobs of the pool
+    indices.resize(m);
+    {
+        auto const nb_buckets = std::clamp<std::size_t>((m + grain - 1) / grain, 1, MAX_BUCKETS);
+        auto& mt = prng_engine();
+        SplitMix64 seeds{std::uint64_t{mt()} << 32 | mt()};
+        std::vector<std::uint64_t> chunk_seeds(nb_buckets), bucket_seeds(nb_buckets);
+        for (auto& seed : chunk_seeds) seed = seeds();
+        for (auto& seed : bucket_seeds) seed = seeds();
+
+        /* Chunk c sends its indices to the buckets twice, counting them and then moving them, with
+        the same draws. */
+        std::vector<std::size_t> offsets(nb_buckets * nb_buckets); // of chunk c in bucket b at [b * nb_buckets + c]
+        auto chunk = [&](std::size_t c) { return std::pair{c * m / nb_buckets, (c + 1) * m / nb_buckets}; };
+        auto const bucket_of = [&](SplitMix64& mt) { return std::uniform_int_distribution<std::size_t>{0, nb_buckets - 1}(mt); };
+        parallel_for(pool, nb_buckets, [&](std::size_t c, std::size_t) {
+            SplitMix64 mt{chunk_seeds[c]};
+            for (auto [first, last] = chunk(c); first < last; ++first) ++offsets[bucket_of(mt) * nb_buckets + c];
+        });
+        std::vector<std::size_t> buckets(nb_buckets + 1);
+        for (std::size_t i = 0, offset = 0; i < std::size(offsets); ++i) {
+            if (i % nb_buckets == 0) buckets[i / nb_buckets] = offset;
+            offset = std::exchange(offsets[i], offset) + offset;
+        }
+        buckets[nb_buckets] = m;
+        parallel_for(pool, nb_buckets, [&](std::size_t c, std::size_t) {
+            SplitMix64 mt{chunk_seeds[c]};
+            for (auto [first, last] = chunk(c); first < last; ++first) indices[offsets[bucket_of(mt) * nb_buckets + c]++] = static_cast<std::uint32_t>(first);
+        });
+        parallel_for(pool, nb_buckets, [&](std::size_t b, std::size_t) {
+            SplitMix64 mt{bucket_seeds[b]};
+            std::shuffle(begin(indices) + buckets[b], begin(indices) + buckets[b + 1], mt);
+        });
+    }
+
+    auto const edge = [&](std::size_t i) { return graph.edges[indices[i]]; };
+    ConcurrentUnionFind<node_t> uf{graph.n};
+    std::size_t start = 0; // the edges before start are contracted
+    for (auto block = grain; uf.nb_subsets.load(std::memory_order_relaxed) > 2 && start < m;) {
+        if (std::size_t const nb_safe = uf.nb_subsets.load(std::memory_order_relaxed) - 2; nb_safe >= grain) {
+            auto const last = std::min(m, start + nb_safe);
+            in_chunks(start, last, [&](std::size_t, std::size_t first, std::size_t last) {
+                for (; first < last; ++first) uf.merge(edge(first).tail, edge(first).head);
+            });
+            start = last;
+            continue;
+        }
+        auto const last = std::min(m, start + block);
+        block *= 2; // the fewer edges left to merge, the fewer survive the filter
+        std::vector<std::vector<std::size_t>> candidates(nb_chunks(last - start));
+        in_chunks(start, last, [&](std::size_t chunk, std::size_t first, std::size_t last) {
+            for (; first < last; ++first)
+                if (!uf.connected(edge(first).tail, edge(first).head)) candidates[chunk].push_back(first);
+        });
+        start = [&] {
+            for (auto const& chunk : candidates)
+                for (auto i : chunk)
+                    if (uf.merge(edge(i).tail, edge(i).head) && uf.nb_subsets.load(std::memory_order_relaxed) == 2) return i + 1;
+            return last;
+        }();
+    }
+
+    auto const nb_count_chunks = nb_chunks(m - start);
+    std::vector<std::size_t> cut_sizes(nb_count_chunks);
+    std::vector<std::vector<Edge<node_t>>> chunk_cut_edges(nb_count_chunks);
+    in_chunks(start, m, [&](std::size_t chunk, std::size_t first, std::size_t last) {
+        for (auto i : std::span{indices}.subspan(first, last - first))
+            if (auto const e = graph.edges[i]; !uf.connected(e.tail, e.head)) {
+                ++cut_sizes[chunk];
+                if (with_cut_edges) chunk_cut_edges[chunk].push_back(e);
+            }
+    });
+    std::vector<Edge<node_t>> cut_edges;
+    for (auto const& chunk : chunk_cut_edges) cut_edges.insert(end(cut_edges), begin(chunk), end(chunk));
+    return {std::accumulate(begin(cut_sizes), end(cut_sizes), std::size_t{0}), uf.to_union_find(), std::move(cut_edges)};
+}
+
+
+/* Karger's contraction algorithm for a single trial on a huge graph, as a minimum spanning tree
+spread over the threads of the pool. Contracting the edges in a random order until two vertices are
+left merges them as Kruskal's algorithm does with the edges weighted by their rank, until it is left
+with the minimum spanning tree without its heaviest edge: the cut is the one of these two trees.
+Each edge i is given the random key of the i-th number of a SplitMix64 stream seeded from the engine
+of the calling thread (ties broken by index), so that the keys cost no memory and the cut doesn't
+depend on the number of threads. The tree is built by Borůvka's algorithm on a ConcurrentUnionFind:
+at each round, the lightest edge leaving each tree is found in parallel (by CAS on the tree's
+current best edge), all of them are merged at once (they form a forest since the keys are distinct),
+and the edges now inside a tree are dropped (parallel_partition()). The trees at least halve at each
+round, in O(log n) rounds. The heaviest edge of the tree is then left out of a UnionFind merging the
+others, and the cut is counted in parallel. grain is the least number of edges or vertices given to
+a thread at each step. The graph is assumed to be connected. Must not be called from a job of the
+pool. */
+template <typename node_t>
+GraphCut<node_t> parallel_karger_mst(EdgesVectorGraph<node_t> const& graph, ThreadPool& pool,
+    bool with_cut_edges = false, std::size_t grain = 1 << 14)
+{
+    constexpr auto NONE = std::numeric_limits<std::uint32_t>::max();
+    if (std::size(graph.edges) >= NONE) throw std::length_error("Too many edges for 32-bit indices.");
+    auto const m = static_cast<std::uint32_t>(std::size(graph.edges));
+    auto& mt = prng_engine();
+    auto const seed = std::uint64_t{mt()} << 32 | mt();
+    auto const key = [seed](std::uint32_t i) { return SplitMix64{seed + i * 0x9e3779b97f4a7c15}(); };
+    auto const lighter = [&](std::uint32_t i, std::uint32_t j) { auto const a = key(i), b = key(j); return a != b ? a < b : i < j; };
+
+    thread_local static std::vector<std::uint32_t> buffer;
+    auto& live = buffer; // the one of the calling thread, for the jobs of the pool
+    live.resize(m);
+    parallel_chunks(pool, 0, m, grain, [&](std::size_t, std::size_t first, std::size_t last) {
+        std::iota(begin(live) + first, begin(live) + last, static_cast<std::uint32_t>(first));
+    });
+
+    ConcurrentUnionFind<node_t> forest{graph.n};
+    std::vector<std::atomic<std::uint32_t>> lightest(graph.n); // edge leaving each tree, at its root
+    for (auto& i : lightest) i.store(NONE, std::memory_order_relaxed);
+    std::vector<std::uint32_t> tree(graph.n);
+    std::atomic<std::size_t> tree_size{0};
+    auto const offer = [&](node_t root, std::uint32_t i) {
+        auto current = lightest[root].load(std::memory_order_relaxed);
+        while ((current == NONE || lighter(i, current))
+               && !lightest[root].compare_exchange_weak(current, i, std::memory_order_relaxed)) {}
+    };
+    for (std::span edges{live}; !edges.empty() && forest.nb_subsets.load(std::memory_order_relaxed) > 1;) {
+        auto const nb_left = parallel_partition(edges, [&](std::uint32_t i) {
+            return !forest.connected(graph.edges[i].tail, graph.edges[i].head);
+        }, &pool);
+        edges = edges.first(nb_left);
+        parallel_chunks(pool, 0, std::size(edges), grain, [&](std::size_t, std::size_t first, std::size_t last) {
+            for (auto i : edges.subspan(first, last - first)) {
+                offer(forest.find(graph.edges[i].tail), i);
+                offer(forest.find(graph.edges[i].head), i);
+            }
+        });
+        parallel_chunks(pool, 0, graph.n, grain, [&](std::size_t, std::size_t first, std::size_t last) {
+            for (auto root = first; root < last; ++root)
+                if (auto const i = lightest[root].exchange(NONE, std::memory_order_relaxed);
+                    i != NONE && forest.merge(graph.edges[i].tail, graph.edges[i].head))
+                    tree[tree_size.fetch_add(1, std::memory_order_relaxed)] = i;
+        });
+    }
+
+    auto const edges_of_tree = std::span{tree}.first(tree_size.load(std::memory_order_relaxed));
+    auto const heaviest = std::ranges::max_element(edges_of_tree, lighter);
+    UnionFind<node_t> uf{graph.n};
+    for (auto it = begin(edges_of_tree); it != end(edges_of_tree); ++it)
+        if (it != heaviest) uf.merge(graph.edges[*it].tail, graph.edges[*it].head);
+    std::vector<node_t> roots(graph.n);
+    for (node_t u = 0; u < graph.n; ++u) roots[u] = uf.find(u);
+
+    auto const nb_chunks = parallel_chunk_count(pool, m, grain);
+    std::vector<std::size_t> cut_sizes(nb_chunks);
+    std::vector<std::vector<Edge<node_t>>> chunk_cut_edges(nb_chunks);
+    parallel_chunks(pool, 0, m, grain, [&](std::size_t chunk, std::size_t first, std::size_t last) {
+        for (auto e : std::span{graph.edges}.subspan(first, last - first))
+            if (roots[e.tail] != roots[e.head]) {
+                ++cut_sizes[chunk];
+                if (with_cut_edges) chunk_cut_edges[chunk].push_back(e);
+            }
+    });
+    std::vector<Edge<node_t>> cut_edges;
+    for (auto const& chunk : chunk_cut_edges) cut_edges.insert(end(cut_edges), begin(chunk), end(chunk));
+    return {std::accumulate(begin(cut_sizes), end(cut_sizes), std::size_t{0}), std::move(uf), std::move(cut_edges)};
+}
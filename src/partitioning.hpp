@@ -0,0 +1,157 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <mutex>
+#include <numeric>
+#include <optional>
+#include <span>
+#include <vector>
+#include "karger.hpp"
+#include "parallel.hpp"
+#include "subgraphs.hpp"
+
+
+/* Result of a recursive bisection. Each cluster owns a contiguous range of vertices (their original
+indices) and a contiguous range of the edges of the graph, which have been reordered in place: the
+edges of its first child, those of its second child, then the edges its cut crosses (from the first
+child to the second, each end numbered in its child). The edges of a cluster are numbered locally,
+vertex u being vertices[first_vertex + u]. clusters[0] is the whole graph, and children always come
+after their parent. */
+template <typename node_t>
+struct ClusterTree
+{
+    static constexpr std::size_t NONE = 0; // the root is never a child
+
+    struct Cluster {
+        std::size_t first_vertex, nb_vertices;
+        std::size_t first_edge, nb_edges;
+        std::size_t depth;
+        std::size_t cut_size = 0; // of the split, if not a leaf
+        std::size_t children[2] = {NONE, NONE};
+        bool is_leaf() const { return children[0] == NONE; }
+    };
+
+    EdgesVectorGraph<node_t> graph;
+    std::vector<node_t> vertices;
+    std::vector<Cluster> clusters;
+};
+
+
+/* Splits a cluster of the tree along the given sides of its vertices with split_by_cut(): its
+vertices are reordered so that the first side comes first, and its edges are partitioned in place.
+Returns the two children, which are left to be added to the tree. Disjoint clusters can be split
+concurrently, without a pool. */
+template <typename node_t>
+auto split_cluster(ClusterTree<node_t>& tree, std::size_t c, std::vector<std::uint8_t> const& sides, ThreadPool* pool)
+{
+    auto& cluster = tree.clusters[c];
+    auto const split = split_by_cut(std::span{tree.graph.edges}.subspan(cluster.first_edge, cluster.nb_edges), sides, true, pool);
+    auto const vertices = std::span{tree.vertices}.subspan(cluster.first_vertex, cluster.nb_vertices);
+    std::vector<node_t> reordered;
+    reordered.reserve(std::size(vertices));
+    for (auto const& side : split.vertices)
+        for (auto u : side) reordered.push_back(vertices[u]);
+    std::ranges::copy(reordered, begin(vertices));
+
+    cluster.cut_size = std::size(split.crossing);
+    auto const depth = cluster.depth + 1;
+    typename ClusterTree<node_t>::Cluster const first{cluster.first_vertex, std::size(split.vertices[0]),
+        cluster.first_edge, std::size(split.inside[0]), depth};
+    typename ClusterTree<node_t>::Cluster const second{cluster.first_vertex + first.nb_vertices, std::size(split.vertices[1]),
+        first.first_edge + first.nb_edges, std::size(split.inside[1]), depth};
+    return std::array{first, second};
+}
+
+
+/* Recursive bisection of a graph into a tree of clusters, splitting each cluster by the best cut
+found by ⌈ln²(n)⌉ Karger-Stein runs, down to max_depth or to clusters of less than min_size
+vertices. With balanced, the cut minimizing the ratio cut_size / (|A| |B|) among as many runs of
+Karger's algorithm is taken instead, which favors balanced clusters. A disconnected cluster is split
+between the component of its first vertex and the others. The recursion goes level by level: the
+clusters of a level are split in parallel on the pool, or one at a time with their runs in parallel
+if there are fewer clusters than threads. Runs are seeded from the seed, the cluster and their
+index. The edges are moved into the tree and only reordered, the graph given to the runs being a
+per-worker copy of the edges of a cluster. */
+template <typename node_t>
+ClusterTree<node_t> recursive_bisection(EdgesVectorGraph<node_t> graph, ThreadPool& pool, std::uint64_t seed,
+    std::size_t max_depth, std::size_t min_size = 2, bool balanced = false)
+{
+    ClusterTree<node_t> tree{std::move(graph), {}, {}};
+    auto const n = tree.graph.n;
+    tree.vertices.resize(n);
+    std::iota(begin(tree.vertices), end(tree.vertices), node_t{0});
+    tree.clusters.push_back({0, n, 0, std::size(tree.graph.edges), 0});
+    std::vector<EdgesVectorGraph<node_t>> copies(pool.size());
+    min_size = std::max<std::size_t>(min_size, 2);
+
+    auto copy_of = [&](std::size_t c, std::size_t worker) -> EdgesVectorGraph<node_t>& {
+        auto const& cluster = tree.clusters[c];
+        auto& copy = copies[worker];
+        copy.n = cluster.nb_vertices;
+        auto const edges = std::span{tree.graph.edges}.subspan(cluster.first_edge, cluster.nb_edges);
+        copy.edges.assign(begin(edges), end(edges));
+        return copy;
+    };
+
+    auto score = [balanced](GraphCut<node_t> const& cut, std::vector<std::uint8_t> const& sides) {
+        if (!balanced) return static_cast<double>(cut.cut_size);
+        double const nb_second = std::ranges::count(sides, 1);
+        return cut.cut_size / (nb_second * (std::size(sides) - nb_second));
+    };
+
+    /* Sides of the best cut of the cluster, its runs being spread over the pool if parallel. */
+    auto best_sides = [&](std::size_t c, std::size_t worker, bool parallel) {
+        auto const& cluster = tree.clusters[c];
+        if (!is_connected(copy_of(c, worker))) {
+            UnionFind<node_t> uf{copies[worker].n};
+            for (auto e : copies[worker].edges) uf.merge(e.tail, e.head);
+            return GraphCut<node_t>{0, std::move(uf)}.get_sides();
+        }
+        auto const nb_runs = std::max<std::size_t>(1, std::ceil(std::pow(std::log(cluster.nb_vertices), 2)));
+        std::mutex mutex;
+        std::optional<std::vector<std::uint8_t>> best;
+        double best_score = std::numeric_limits<double>::infinity();
+        std::atomic<std::size_t> incumbent{std::numeric_limits<std::size_t>::max()};
+        auto run = [&](std::size_t i, std::size_t worker) {
+            auto const& copy = copies[parallel ? 0 : worker]; // the runs only read it
+            seed_trial(seed, std::uint64_t{c} << 32 | i);
+            auto const cut = balanced ? karger_union_find(copy) : karger_stein_union_find(copy, &incumbent);
+            if (cut.cut_size == std::numeric_limits<std::size_t>::max()) return; // pruned by the incumbent
+            auto sides = cut.get_sides();
+            auto const s = score(cut, sides);
+            std::scoped_lock lock{mutex};
+            if (s < best_score) { best_score = s; best = std::move(sides); atomic_fetch_min(incumbent, cut.cut_size); }
+        };
+        if (parallel) parallel_for(pool, nb_runs, run);
+        else for (std::size_t i = 0; i < nb_runs; ++i) run(i, worker);
+        return std::move(*best);
+    };
+
+    std::vector<std::size_t> level{0}, next_level;
+    std::vector<std::array<typename ClusterTree<node_t>::Cluster, 2>> children;
+    for (std::size_t depth = 0; depth < max_depth && !level.empty(); ++depth) {
+        std::erase_if(level, [&](auto c) { return tree.clusters[c].nb_vertices < min_size; });
+        children.resize(std::size(level));
+        if (std::size(level) < pool.size())
+            for (std::size_t i = 0; i < std::size(level); ++i)
+                children[i] = split_cluster(tree, level[i], best_sides(level[i], 0, true), &pool);
+        else
+            parallel_for(pool, std::size(level), [&](std::size_t i, std::size_t worker) {
+                children[i] = split_cluster(tree, level[i], best_sides(level[i], worker, false), nullptr);
+            });
+        next_level.clear();
+        for (std::size_t i = 0; i < std::size(level); ++i)
+            for (std::size_t j = 0; j < 2; ++j) {
+                tree.clusters[level[i]].children[j] = std::size(tree.clusters);
+                next_level.push_back(std::size(tree.clusters));
+                tree.clusters.push_back(children[i][j]);
+            }
+        std::swap(level, next_level);
+    }
+    return tree;
+}
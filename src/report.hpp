@@ -0,0 +1,137 @@
+#pragma once
+
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+
+/* Output of the executable: human-readable text, or a machine-readable record per run. */
+enum class OutputFormat { text, json, csv };
+
+inline OutputFormat parse_output_format(std::string_view name)
+{
+    if (name == "text") return OutputFormat::text;
+    if (name == "json") return OutputFormat::json;
+    if (name == "csv") return OutputFormat::csv;
+    throw std::runtime_error("Unknown output format \"" + std::string{name} + "\".");
+}
+
+
+/* Result of an engine on an instance. The load and setup times are those of the instance, shared by
+its engines, and the solve time is the engine's own. sides gives the side (0 or 1) of each vertex in
+the best cut, if asked for, and the numbers of removed edges are given if the instance has been
+normalized (then n and m are those of the normalized graph). */
+struct RunRecord
+{
+    std::string instance;
+    std::size_t n = 0, m = 0;
+    std::string engine;
+    std::size_t nb_trials = 0;
+    std::optional<std::size_t> cut_size, known_min_cut;
+    double load_ms = 0, setup_ms = 0, solve_ms = 0;
+    std::uint64_t seed = 0;
+    std::size_t nb_threads = 0, nb_processes = 0;
+    std::optional<std::string> sides;
+    std::optional<std::size_t> removed_self_loops = {}, removed_duplicates = {};
+};
+
+
+/* Streams records as JSON Lines (an object per line), as CSV (a header, then a row per record) or
+as a line of text. Each record is written at once and flushed, so that a batch run can be followed
+while it goes and stays readable if it is killed. Records can be written from several threads. */
+class RecordWriter
+{
+public:
+    RecordWriter(std::ostream& out, OutputFormat format) : out{out}, format{format} {}
+
+    void write(RunRecord const& record)
+    {
+        std::string line;
+        if (format == OutputFormat::text) {
+            line = '"' + record.instance + "\" (|V| = " + std::to_string(record.n) + ", |E| = " + std::to_string(record.m)
+                + "), " + record.engine + ": " + (record.cut_size ? std::to_string(*record.cut_size) : "none") + " ("
+                + std::to_string(record.nb_trials) + " repetitions, " + number(record.solve_ms) + "ms)\n";
+            if (record.sides) line += "    - Sides: " + *record.sides + '\n';
+        } else if (format == OutputFormat::json) {
+            auto field = [&](std::string_view name, std::string const& value) {
+                line += line.empty() ? "{\"" : ", \"";
+                line += name;
+                line += "\": ";
+                line += value;
+            };
+            field("instance", json_string(record.instance));
+            field("n", std::to_string(record.n));
+            field("m", std::to_string(record.m));
+            field("engine", json_string(record.engine));
+            field("trials", std::to_string(record.nb_trials));
+            field("cut_size", record.cut_size ? std::to_string(*record.cut_size) : "null");
+            field("known_min_cut", record.known_min_cut ? std::to_string(*record.known_min_cut) : "null");
+            field("load_ms", number(record.load_ms));
+            field("setup_ms", number(record.setup_ms));
+            field("solve_ms", number(record.solve_ms));
+            field("seed", std::to_string(record.seed));
+            field("threads", std::to_string(record.nb_threads));
+            field("processes", std::to_string(record.nb_processes));
+            if (record.sides) field("sides", json_string(*record.sides));
+            if (record.removed_self_loops) field("removed_self_loops", std::to_string(*record.removed_self_loops));
+            if (record.removed_duplicates) field("removed_duplicates", std::to_string(*record.removed_duplicates));
+            line += "}\n";
+        } else {
+            auto optional = [](std::optional<std::size_t> value) { return value ? std::to_string(*value) : ""; };
+            line = csv_string(record.instance) + ',' + std::to_string(record.n) + ',' + std::to_string(record.m) + ','
+                + csv_string(record.engine) + ',' + std::to_string(record.nb_trials) + ',' + optional(record.cut_size) + ','
+                + optional(record.known_min_cut) + ',' + number(record.load_ms) + ',' + number(record.setup_ms) + ','
+                + number(record.solve_ms) + ',' + std::to_string(record.seed) + ',' + std::to_string(record.nb_threads) + ','
+                + std::to_string(record.nb_processes) + ',' + record.sides.value_or("") + ','
+                + optional(record.removed_self_loops) + ',' + optional(record.removed_duplicates) + '\n';
+        }
+
+        std::scoped_lock lock{mutex};
+        if (format == OutputFormat::csv && !header_written) {
+            out << "instance,n,m,engine,trials,cut_size,known_min_cut,load_ms,setup_ms,solve_ms,seed,threads,processes,sides,removed_self_loops,removed_duplicates\n";
+            header_written = true;
+        }
+        out << line << std::flush;
+    }
+
+private:
+    static std::string number(double value)
+    {
+        auto const rounded = static_cast<std::uint64_t>(value * 1000 + 0.5); // to the microsecond
+        auto fraction = std::to_string(rounded % 1000);
+        return std::to_string(rounded / 1000) + '.' + std::string(3 - std::size(fraction), '0') + fraction;
+    }
+
+    static std::string json_string(std::string_view value)
+    {
+        std::string escaped = "\"";
+        for (char c : value) {
+            if (c == '"' || c == '\\') { escaped += '\\'; escaped += c; }
+            else if (static_cast<unsigned char>(c) < 0x20) {
+                char const* const digits = "0123456789abcdef";
+                escaped += "\\u00";
+                escaped += digits[c >> 4];
+                escaped += digits[c & 0xF];
+            }
+            else escaped += c;
+        }
+        return escaped + '"';
+    }
+
+    static std::string csv_string(std::string_view value)
+    {
+        if (value.find_first_of(",\"\r\n") == std::string_view::npos) return std::string{value};
+        std::string quoted = "\"";
+        for (char c : value) { if (c == '"') quoted += '"'; quoted += c; }
+        return quoted + '"';
+    }
+
+    std::ostream& out;
+    OutputFormat format;
+    std::mutex mutex;
+    bool header_written = false;
+};
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+#include "karger.hpp"
+
+
+/* Karger's skeleton of a graph: each edge is kept independently with probability p. Kept edges are
+found by drawing the geometric gaps between them, in O(pm) random draws. */
+template <typename node_t, typename URBG>
+EdgesVectorGraph<node_t> skeleton(EdgesVectorGraph<node_t> const& graph, double p, URBG& mt)
+{
+    if (p >= 1) return graph;
+    EdgesVectorGraph<node_t> sampled{graph.n, {}};
+    sampled.edges.reserve(static_cast<std::size_t>(1.1 * p * std::size(graph.edges)) + 1);
+    std::geometric_distribution<std::size_t> gap{p};
+    for (auto i = gap(mt); i < std::size(graph.edges); i += 1 + gap(mt))
+        sampled.edges.push_back(graph.edges[i]);
+    return sampled;
+}
+
+
+/* A skeleton of a graph along with its sampling probability. */
+template <typename node_t>
+struct Skeleton
+{
+    double p;
+    EdgesVectorGraph<node_t> graph;
+};
+
+
+/* Skeleton for a (1 + ε)-approximate minimum cut. If a graph with minimum cut λ is sampled with
+probability p = 3 ln(n) / (ε² λ), all its cuts are, with high probability, within a factor 1 ± ε of
+p times their size [Karger, Random Sampling in Cut, Flow, and Network Design Problems, 1994]: the
+minimum cut of the skeleton is then a (1 + O(ε))-approximate minimum cut of the graph. Since λ is
+unknown, the search starts from the minimum degree (an upper bound of λ) and the probability is
+doubled as long as the skeleton is disconnected or a Karger-Stein run finds one of its cuts below
+3 ln(n) / ε², which proves that λ is smaller than assumed. The skeleton returned is the one which
+passed these checks, hence connected if the graph is (the graph itself once p reaches 1). */
+template <typename node_t, typename URBG>
+Skeleton<node_t> approximate_skeleton(EdgesVectorGraph<node_t> const& graph, double epsilon, URBG& mt)
+{
+    if (graph.n < 2) return {1, graph};
+    auto const target = 3 * std::log(graph.n) / (epsilon * epsilon);
+    for (auto p = target / minimum_degree_cut(graph).cut_size; p < 1; p *= 2)
+        if (auto sampled = skeleton(graph, p, mt); is_connected(sampled) && karger_stein_union_find(sampled).cut_size >= target)
+            return {p, std::move(sampled)};
+    return {1, graph};
+}
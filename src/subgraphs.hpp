@@ -0,0 +1,152 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <span>
+#include <utility>
+#include <vector>
+#include "karger.hpp"
+#include "parallel.hpp"
+
+
+/* Reorders the range in place so that the elements satisfying pred come first, and returns their
+number. With a pool, large ranges are cut into a chunk per thread, each partitioned in parallel;
+the elements then lying on the wrong side of the global partition point (the false elements before
+it and the true elements after it, which are as many) are swapped pairwise in parallel, the k-th
+misplaced false element with the k-th misplaced true one. Must not be called from a job of the
+pool. */
+template <typename T, typename Pred>
+std::size_t parallel_partition(std::span<T> range, Pred pred, ThreadPool* pool = nullptr)
+{
+    constexpr std::size_t PARALLEL_MIN_SIZE = 1 << 16;
+    if (!pool || pool->size() < 2 || std::size(range) < PARALLEL_MIN_SIZE)
+        return std::partition(begin(range), end(range), pred) - begin(range);
+
+    auto const nb_chunks = pool->size();
+    std::vector<std::size_t> bounds(nb_chunks + 1), middles(nb_chunks);
+    for (std::size_t i = 0; i <= nb_chunks; ++i) bounds[i] = i * std::size(range) / nb_chunks;
+    parallel_for(*pool, nb_chunks, [&](std::size_t i, std::size_t) {
+        middles[i] = std::partition(begin(range) + bounds[i], begin(range) + bounds[i + 1], pred) - begin(range);
+    });
+    std::size_t nb_true = 0;
+    for (std::size_t i = 0; i < nb_chunks; ++i) nb_true += middles[i] - bounds[i];
+
+    /* Misplaced elements, as intervals of positions along with the number of misplaced elements
+    before each of them. */
+    struct Interval { std::size_t first, last, rank; };
+    std::vector<Interval> falses, trues;
+    std::size_t nb_falses = 0, nb_trues = 0;
+    for (std::size_t i = 0; i < nb_chunks; ++i) {
+        if (auto const last = std::min(bounds[i + 1], nb_true); middles[i] < last) {
+            falses.push_back({middles[i], last, nb_falses});
+            nb_falses += last - middles[i];
+        }
+        if (auto const first = std::max(bounds[i], nb_true); first < middles[i]) {
+            trues.push_back({first, middles[i], nb_trues});
+            nb_trues += middles[i] - first;
+        }
+    }
+    auto position = [](std::vector<Interval> const& intervals, std::size_t rank) {
+        auto const i = std::ranges::upper_bound(intervals, rank, {}, &Interval::rank) - begin(intervals) - 1;
+        return std::pair{static_cast<std::size_t>(i), intervals[i].first + rank - intervals[i].rank};
+    };
+    parallel_for(*pool, nb_chunks, [&](std::size_t j, std::size_t) {
+        auto const first = j * nb_falses / nb_chunks, last = (j + 1) * nb_falses / nb_chunks;
+        if (first == last) return;
+        auto [f, x] = position(falses, first);
+        auto [t, y] = position(trues, first);
+        for (auto rank = first; rank < last; ++rank, ++x, ++y) {
+            if (x == falses[f].last) x = falses[++f].first;
+            if (y == trues[t].last) y = trues[++t].first;
+            std::swap(range[x], range[y]);
+        }
+    });
+    return nb_true;
+}
+
+
+/* Sorts the range in place. With a pool, large ranges are cut into a chunk per thread, sorted in
+parallel, then merged pairwise in parallel rounds. Must not be called from a job of the pool. */
+template <typename T, typename Compare = std::less<>>
+void parallel_sort(std::span<T> range, ThreadPool* pool = nullptr, Compare compare = {})
+{
+    constexpr std::size_t PARALLEL_MIN_SIZE = 1 << 16;
+    if (!pool || pool->size() < 2 || std::size(range) < PARALLEL_MIN_SIZE) {
+        std::sort(begin(range), end(range), compare);
+        return;
+    }
+    auto const nb_chunks = pool->size();
+    std::vector<std::size_t> bounds(nb_chunks + 1);
+    for (std::size_t i = 0; i <= nb_chunks; ++i) bounds[i] = i * std::size(range) / nb_chunks;
+    parallel_for(*pool, nb_chunks, [&](std::size_t i, std::size_t) {
+        std::sort(begin(range) + bounds[i], begin(range) + bounds[i + 1], compare);
+    });
+    for (std::size_t width = 1; width < nb_chunks; width *= 2) // merges runs of width chunks two by two
+        parallel_for(*pool, (nb_chunks + 2 * width - 1) / (2 * width), [&](std::size_t j, std::size_t) {
+            auto const first = 2 * j * width, middle = std::min(first + width, nb_chunks), last = std::min(first + 2 * width, nb_chunks);
+            std::inplace_merge(begin(range) + bounds[first], begin(range) + bounds[middle], begin(range) + bounds[last], compare);
+        });
+}
+
+
+/* The edges of a graph split by a cut: views of its edge vector reordered in place into the edges
+inside side 0, those inside side 1, then the edges crossing the cut. vertices[s] lists the vertices
+of side s in increasing order. */
+template <typename node_t>
+struct CutSplit
+{
+    std::span<Edge<node_t>> inside[2];
+    std::span<Edge<node_t>> crossing;
+    std::vector<node_t> vertices[2];
+};
+
+
+/* Splits the edges by the given side (0 or 1) of each vertex in O(n + m), in parallel with a pool
+for large graphs. With relabel, the vertices are renumbered within their side (vertex u of side s
+becoming i such that vertices[s][i] = u), so that each side is a graph of its own, and the crossing
+edges go from side 0 to side 1, each end numbered in its side. Otherwise, the edges are only
+reordered. Must not be called from a job of the pool. */
+template <typename node_t>
+CutSplit<node_t> split_by_cut(std::span<Edge<node_t>> edges, std::vector<std::uint8_t> const& sides,
+    bool relabel = true, ThreadPool* pool = nullptr)
+{
+    CutSplit<node_t> split;
+    auto const nb_first = parallel_partition(edges, [&](auto e) { return !sides[e.tail] && !sides[e.head]; }, pool);
+    auto const rest = edges.subspan(nb_first);
+    auto const nb_second = parallel_partition(rest, [&](auto e) { return sides[e.tail] && sides[e.head]; }, pool);
+    split.inside[0] = edges.first(nb_first);
+    split.inside[1] = rest.first(nb_second);
+    split.crossing = rest.subspan(nb_second);
+
+    std::vector<node_t> ids(std::size(sides));
+    split.vertices[1].reserve(std::ranges::count(sides, 1));
+    split.vertices[0].reserve(std::size(sides) - std::size(split.vertices[1]));
+    for (node_t u = 0; u < std::size(sides); ++u) {
+        ids[u] = std::size(split.vertices[sides[u]]);
+        split.vertices[sides[u]].push_back(u);
+    }
+    if (!relabel) return split;
+
+    auto relabel_edges = [&](std::size_t first, std::size_t last) {
+        for (auto& e : edges.subspan(first, last - first)) {
+            if (sides[e.tail] > sides[e.head]) std::swap(e.tail, e.head);
+            e = {ids[e.tail], ids[e.head]};
+        }
+    };
+    if (pool && std::size(edges) >= 1 << 16)
+        parallel_for(*pool, pool->size(), [&](std::size_t i, std::size_t) {
+            relabel_edges(i * std::size(edges) / pool->size(), (i + 1) * std::size(edges) / pool->size());
+        });
+    else relabel_edges(0, std::size(edges));
+    return split;
+}
+
+
+/* Same as above, with the sides of the given cut. */
+template <typename node_t>
+CutSplit<node_t> split_by_cut(EdgesVectorGraph<node_t>& graph, GraphCut<node_t> const& cut,
+    bool relabel = true, ThreadPool* pool = nullptr)
+{
+    return split_by_cut(std::span{graph.edges}, cut.get_sides(), relabel, pool);
+}